@@ -10,5 +10,12 @@ public class InteractionSystemTarget : TargetRules
 		Type = TargetType.Game;
 
 		ExtraModuleNames.AddRange( new string[] { "InteractionSystem" } );
+
+#if UE_4_25_OR_LATER
+		// push model replication for interactive components (see WITH_INTERACTION_PUSH_MODEL), WITH_PUSH_MODEL is 0 unless enabled here,
+		// it changes engine modules so it needs a unique build environment (i.e. a source build of the engine)
+		bWithPushModel = true;
+		BuildEnvironment = TargetBuildEnvironment.Unique;
+#endif
 	}
 }
@@ -2,7 +2,90 @@
 
 #include "InteractionSystem.h"
 #include "Modules/ModuleManager.h"
+#include "HAL/PlatformTime.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, InteractionSystem, "InteractionSystem" );
 
-DEFINE_LOG_CATEGORY(LogInteraction)
\ No newline at end of file
+DEFINE_LOG_CATEGORY(LogInteraction)
+
+DEFINE_STAT(STAT_FindInteractive);
+DEFINE_STAT(STAT_TryStopInteraction);
+DEFINE_STAT(STAT_TryInteract);
+DEFINE_STAT(STAT_OnInteract);
+DEFINE_STAT(STAT_OnStopInteraction);
+DEFINE_STAT(STAT_OnRep_InteractionEvent);
+DEFINE_STAT(STAT_ScheduleFocusUpdates);
+DEFINE_STAT(STAT_QueryInteractives);
+DEFINE_STAT(STAT_FindInteractivesForAgents);
+DEFINE_STAT(STAT_MergeLevelIndices);
+DEFINE_STAT(STAT_AdvanceTimerWheel);
+
+DEFINE_STAT(STAT_RegisteredInteractives);
+DEFINE_STAT(STAT_InteractiveInstances);
+DEFINE_STAT(STAT_TickingInteractives);
+DEFINE_STAT(STAT_InteractionTimers);
+DEFINE_STAT(STAT_Interactions);
+DEFINE_STAT(STAT_DeniedInteractions);
+DEFINE_STAT(STAT_FocusUpdates);
+DEFINE_STAT(STAT_DeferredFocusUpdates);
+DEFINE_STAT(STAT_DroppedInteractRequests);
+DEFINE_STAT(STAT_InteractionCommandBatches);
+DEFINE_STAT(STAT_InteractionCommands);
+DEFINE_STAT(STAT_AsyncFocusTraces);
+DEFINE_STAT(STAT_ConfirmedPredictions);
+DEFINE_STAT(STAT_RolledBackPredictions);
+DEFINE_STAT(STAT_InteractionsPerSecond);
+
+CSV_DEFINE_CATEGORY_MODULE(INTERACTIONSYSTEM_API, Interaction, true);
+
+#if ENGINE_MAJOR_VERSION > 4 || ENGINE_MINOR_VERSION >= 26
+UE_TRACE_CHANNEL_DEFINE(InteractionChannel);
+#endif
+
+namespace InteractionStats
+{
+	static FTotals Totals;
+
+	void RecordInteraction(bool bCanInteract)
+	{
+		++Totals.Interactions;
+		INC_DWORD_STAT(STAT_Interactions);
+		CSV_CUSTOM_STAT(Interaction, Interactions, 1, ECsvCustomStatOp::Accumulate);
+		if (false == bCanInteract)
+		{
+			INC_DWORD_STAT(STAT_DeniedInteractions);
+			CSV_CUSTOM_STAT(Interaction, DeniedInteractions, 1, ECsvCustomStatOp::Accumulate);
+		}
+
+#if STATS
+		// interactions per second, averaged over (at least) one second
+		static double WindowStartTime = FPlatformTime::Seconds();
+		static int32 WindowInteractions = 0;
+
+		++WindowInteractions;
+		const double Now = FPlatformTime::Seconds();
+		if (Now - WindowStartTime >= 1.0)
+		{
+			SET_FLOAT_STAT(STAT_InteractionsPerSecond, WindowInteractions / (Now - WindowStartTime));
+			WindowStartTime = Now;
+			WindowInteractions = 0;
+		}
+#endif
+	}
+
+	void RecordCommandBatch(int32 NumCommands)
+	{
+		++Totals.CommandBatches;
+		Totals.Commands += NumCommands;
+
+		INC_DWORD_STAT(STAT_InteractionCommandBatches);
+		INC_DWORD_STAT_BY(STAT_InteractionCommands, NumCommands);
+		CSV_CUSTOM_STAT(Interaction, CommandBatches, 1, ECsvCustomStatOp::Accumulate);
+		CSV_CUSTOM_STAT(Interaction, Commands, NumCommands, ECsvCustomStatOp::Accumulate);
+	}
+
+	const FTotals& GetTotals()
+	{
+		return Totals;
+	}
+}
\ No newline at end of file
@@ -3,7 +3,102 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Runtime/Launch/Resources/Version.h"
 
-DECLARE_LOG_CATEGORY_EXTERN(LogInteraction, Log, All);
+#if ENGINE_MAJOR_VERSION > 4 || ENGINE_MINOR_VERSION >= 26
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#endif
+
+INTERACTIONSYSTEM_API DECLARE_LOG_CATEGORY_EXTERN(LogInteraction, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("Interaction"), STATGROUP_Interaction, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("FindInteractive"), STAT_FindInteractive, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("TryStopInteraction"), STAT_TryStopInteraction, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("TryInteract"), STAT_TryInteract, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("OnInteract"), STAT_OnInteract, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("OnStopInteraction"), STAT_OnStopInteraction, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("OnRep_InteractionEvent"), STAT_OnRep_InteractionEvent, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ScheduleFocusUpdates"), STAT_ScheduleFocusUpdates, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("QueryInteractives"), STAT_QueryInteractives, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("FindInteractivesForAgents"), STAT_FindInteractivesForAgents, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("MergeLevelIndices"), STAT_MergeLevelIndices, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AdvanceTimerWheel"), STAT_AdvanceTimerWheel, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Registered Interactives"), STAT_RegisteredInteractives, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Interactive Instances"), STAT_InteractiveInstances, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Ticking Interactives"), STAT_TickingInteractives, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Interaction Timers"), STAT_InteractionTimers, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interactions"), STAT_Interactions, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Denied Interactions"), STAT_DeniedInteractions, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Focus Updates"), STAT_FocusUpdates, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Deferred Focus Updates"), STAT_DeferredFocusUpdates, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Dropped Interact Requests"), STAT_DroppedInteractRequests, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Command Batches"), STAT_InteractionCommandBatches, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Interaction Commands"), STAT_InteractionCommands, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Async Focus Traces"), STAT_AsyncFocusTraces, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Confirmed Predictions"), STAT_ConfirmedPredictions, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Rolled Back Predictions"), STAT_RolledBackPredictions, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Interactions Per Second"), STAT_InteractionsPerSecond, STATGROUP_Interaction, INTERACTIONSYSTEM_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(INTERACTIONSYSTEM_API, Interaction);
+
+#if ENGINE_MAJOR_VERSION > 4 || ENGINE_MINOR_VERSION >= 26
+UE_TRACE_CHANNEL_EXTERN(InteractionChannel, INTERACTIONSYSTEM_API);
+#define INTERACTION_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Name, InteractionChannel)
+#else
+// no Unreal Insights before 4.23, trace channels since 4.26
+#define INTERACTION_TRACE_SCOPE(Name)
+#endif
+
+/**
+* Push model replication (4.25+): replicated properties of interactive components are compared only after being marked dirty,
+* so unchanged interactives cost nothing at replication time. Needs WITH_PUSH_MODEL (bWithPushModel in the targets) and net.IsPushModelEnabled,
+* on older engines INTERACTION_MARK_PROPERTY_DIRTY does nothing.
+*/
+#if ENGINE_MAJOR_VERSION > 4 || ENGINE_MINOR_VERSION >= 25
+#include "Net/Core/PushModel/PushModel.h"
+#define WITH_INTERACTION_PUSH_MODEL 1
+#define INTERACTION_MARK_PROPERTY_DIRTY(ClassName, PropertyName, Object) MARK_PROPERTY_DIRTY_FROM_NAME(ClassName, PropertyName, Object)
+#else
+#define WITH_INTERACTION_PUSH_MODEL 0
+#define INTERACTION_MARK_PROPERTY_DIRTY(ClassName, PropertyName, Object)
+#endif
+
+/**
+* Scoped cycle counter that feeds stats (STAT_Name), the csv profiler (Interaction category) and the Unreal Insights InteractionChannel.
+*/
+#define INTERACTION_SCOPE_CYCLE_COUNTER(Name) \
+	SCOPE_CYCLE_COUNTER(STAT_##Name); \
+	CSV_SCOPED_TIMING_STAT(Interaction, Name); \
+	INTERACTION_TRACE_SCOPE(Name)
+
+namespace InteractionStats
+{
+	/**
+	* [server] count a processed interaction (succeeded or denied)
+	*/
+	INTERACTIONSYSTEM_API void RecordInteraction(bool bCanInteract);
+
+	/**
+	* [server] count a batch of commands received from a client, see APlayerPawn::ServerProcessInteractionCommands
+	*/
+	INTERACTIONSYSTEM_API void RecordCommandBatch(int32 NumCommands);
+
+	/**
+	* running totals since startup, all worlds included (e.g. for Interaction.LoadTest)
+	*/
+	struct FTotals
+	{
+		int64 Interactions = 0;
+		int64 CommandBatches = 0;
+		int64 Commands = 0;
+	};
+
+	INTERACTIONSYSTEM_API const FTotals& GetTotals();
+}
 
 #define COLLISION_INTERACTIVE		ECC_GameTraceChannel11
\ No newline at end of file
@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractionFocusCandidates.h"
+#include "Math/VectorRegister.h"
+
+void FInteractionFocusCandidates::Reset()
+{
+	Interactives.Reset();
+	X.Reset();
+	Y.Reset();
+	Z.Reset();
+	Priorities.Reset();
+	Scores.Reset();
+}
+
+void FInteractionFocusCandidates::Add(UObject* Interactive, const FVector& Location, float Priority)
+{
+	const int32 Index = Interactives.Add(Interactive);
+
+	if (Index == X.Num())
+	{
+		// grow by a full SIMD lane group, padding lanes are rejected when scoring
+		const int32 NewNum = X.Num() + 4;
+		X.SetNumZeroed(NewNum, false);
+		Y.SetNumZeroed(NewNum, false);
+		Z.SetNumZeroed(NewNum, false);
+		Priorities.SetNumZeroed(NewNum, false);
+		Scores.SetNumZeroed(NewNum, false);
+	}
+
+	X[Index] = Location.X;
+	Y[Index] = Location.Y;
+	Z[Index] = Location.Z;
+	Priorities[Index] = Priority;
+}
+
+void FInteractionFocusCandidates::Score(const FVector& ViewLocation, const FVector& ViewDirection, float MaxDistance, float ConeHalfAngle, float DistanceWeight)
+{
+	const float CosCone = FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(ConeHalfAngle, 0.f, 89.f)));
+
+	// padding lanes are moved onto the view location, where the squared distance check below rejects them
+	for (int32 Index = Interactives.Num(); Index < X.Num(); ++Index)
+	{
+		X[Index] = ViewLocation.X;
+		Y[Index] = ViewLocation.Y;
+		Z[Index] = ViewLocation.Z;
+	}
+
+	const VectorRegister ViewX = VectorSetFloat1(ViewLocation.X);
+	const VectorRegister ViewY = VectorSetFloat1(ViewLocation.Y);
+	const VectorRegister ViewZ = VectorSetFloat1(ViewLocation.Z);
+	const VectorRegister DirX = VectorSetFloat1(ViewDirection.X);
+	const VectorRegister DirY = VectorSetFloat1(ViewDirection.Y);
+	const VectorRegister DirZ = VectorSetFloat1(ViewDirection.Z);
+	const VectorRegister MinDistanceSquared = VectorSetFloat1(KINDA_SMALL_NUMBER);
+	const VectorRegister MaxDistanceSquared = VectorSetFloat1(FMath::Square(MaxDistance));
+	const VectorRegister DistanceScale = VectorSetFloat1(DistanceWeight / FMath::Max(MaxDistance, KINDA_SMALL_NUMBER));
+	const VectorRegister DistanceBias = VectorSetFloat1(DistanceWeight);
+	const VectorRegister CosConeRegister = VectorSetFloat1(CosCone);
+	const VectorRegister AngleScale = VectorSetFloat1(1.f / FMath::Max(1.f - CosCone, KINDA_SMALL_NUMBER));
+	const VectorRegister Rejected = VectorSetFloat1(-1.f);
+
+	for (int32 Index = 0; Index < X.Num(); Index += 4)
+	{
+		const VectorRegister DX = VectorSubtract(VectorLoad(&X[Index]), ViewX);
+		const VectorRegister DY = VectorSubtract(VectorLoad(&Y[Index]), ViewY);
+		const VectorRegister DZ = VectorSubtract(VectorLoad(&Z[Index]), ViewZ);
+
+		const VectorRegister DistanceSquared = VectorMultiplyAdd(DX, DX, VectorMultiplyAdd(DY, DY, VectorMultiply(DZ, DZ)));
+		const VectorRegister InvDistance = VectorReciprocalSqrt(VectorMax(DistanceSquared, MinDistanceSquared));
+		const VectorRegister Distance = VectorMultiply(DistanceSquared, InvDistance);
+
+		// cos of the angle between view direction and candidate direction
+		const VectorRegister Along = VectorMultiplyAdd(DX, DirX, VectorMultiplyAdd(DY, DirY, VectorMultiply(DZ, DirZ)));
+		const VectorRegister CosAngle = VectorMultiply(Along, InvDistance);
+
+		// angle score 1 on the view ray down to 0 on the cone, distance score DistanceWeight at the view location down to 0 at MaxDistance
+		const VectorRegister AngleScore = VectorMultiply(VectorSubtract(CosAngle, CosConeRegister), AngleScale);
+		const VectorRegister DistanceScore = VectorSubtract(DistanceBias, VectorMultiply(Distance, DistanceScale));
+		const VectorRegister Score = VectorAdd(VectorAdd(AngleScore, DistanceScore), VectorLoad(&Priorities[Index]));
+
+		const VectorRegister InCone = VectorCompareGE(CosAngle, CosConeRegister);
+		const VectorRegister InRange = VectorBitwiseAnd(VectorCompareGE(MaxDistanceSquared, DistanceSquared), VectorCompareGT(DistanceSquared, MinDistanceSquared));
+		const VectorRegister Valid = VectorBitwiseAnd(InCone, InRange);
+
+		// a valid candidate with a very low priority must still beat rejected ones
+		VectorStore(VectorSelect(Valid, VectorMax(Score, VectorZero()), Rejected), &Scores[Index]);
+	}
+}
+
+int32 FInteractionFocusCandidates::FindBest() const
+{
+	int32 BestIndex = INDEX_NONE;
+	float BestScore = 0.f;
+	for (int32 Index = 0; Index < Interactives.Num(); ++Index)
+	{
+		if (Scores[Index] >= BestScore)
+		{
+			BestScore = Scores[Index];
+			BestIndex = Index;
+		}
+	}
+	return BestIndex;
+}
@@ -0,0 +1,497 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractionFocusComponent.h"
+#include "PlayerPawn.h"
+#include "Interactive.h"
+#include "InteractiveInstanced.h"
+#include "InteractiveDispatch.h"
+#include "InteractionSystem.h"
+#include "InteractiveBoxComponent.h"
+#include "InteractionSubsystem.h"
+#include "TimerManager.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/World.h"
+
+FOnInteractionFocusEnabledChanged UInteractionFocusComponent::OnFocusEnabledChanged;
+
+UInteractionFocusComponent::UInteractionFocusComponent()
+{
+	// focus is updated on demand, see SetFocusEnabled
+	PrimaryComponentTick.bCanEverTick = false;
+
+	MaxInteractionDistance = 100.f;
+	bAsyncFocusTrace = false;
+	FocusMode = EInteractionFocusMode::Trace;
+	FocusConeAngle = 10.f;
+	FocusDistanceWeight = 0.25f;
+	InteractionStatePollInterval = 0.1f;
+
+	bFocusEnabled = false;
+	CurrentInteractive = nullptr;
+	CurrentInstance = INDEX_NONE;
+}
+
+void UInteractionFocusComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	SetFocusEnabled(false);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UInteractionFocusComponent::SetFocusEnabled(bool bEnabled)
+{
+	if (bFocusEnabled == bEnabled)
+	{
+		return;
+	}
+	bFocusEnabled = bEnabled;
+
+	UInteractionSubsystem* InteractionSubsystem = UInteractionSubsystem::Get(this);
+	if (bEnabled)
+	{
+		// focus is updated on demand, when the view or nearby interactives change (see UInteractionSubsystem)
+		if (InteractionSubsystem)
+		{
+			InteractionSubsystem->RegisterFocusSource(this, MaxInteractionDistance,
+				FGetFocusView::CreateUObject(this, &UInteractionFocusComponent::GetFocusView),
+				FSimpleDelegate::CreateUObject(this, &UInteractionFocusComponent::FindInteractive));
+		}
+		else
+		{
+			GetWorld()->GetTimerManager().SetTimer(TimerHandle_FindInteractive,
+				this,
+				&UInteractionFocusComponent::FindInteractive,
+				0.128f, // rate
+				true // loop
+			);
+		}
+	}
+	else
+	{
+		if (InteractionSubsystem)
+		{
+			InteractionSubsystem->UnregisterFocusSource(this);
+			InteractionSubsystem->CancelFocusTrace(this);
+		}
+		if (UWorld* World = GetWorld())
+		{
+			World->GetTimerManager().ClearTimer(TimerHandle_FindInteractive);
+		}
+
+		// focus lost, e.g. unpossessed
+		UpdateFocus(nullptr);
+	}
+
+	OnFocusEnabledChanged.Broadcast(this, bEnabled);
+}
+
+APlayerPawn* UInteractionFocusComponent::GetPlayerPawn() const
+{
+	return CastChecked<APlayerPawn>(GetOwner());
+}
+
+APlayerController* UInteractionFocusComponent::GetLocalPlayerController() const
+{
+	APlayerController* PC = Cast<APlayerController>(GetPlayerPawn()->GetController());
+	return PC && PC->IsLocalController() ? PC : nullptr;
+}
+
+void UInteractionFocusComponent::FindInteractive()
+{
+	INTERACTION_SCOPE_CYCLE_COUNTER(FindInteractive);
+
+	UObject* Interactive = nullptr;
+	int32 Instance = INDEX_NONE;
+	const APlayerController* PC = GetLocalPlayerController();
+	if (PC)
+	{
+		const APlayerCameraManager* Camera = PC->PlayerCameraManager;
+		if (Camera)
+		{
+			if (FocusMode == EInteractionFocusMode::Cone)
+			{
+				Interactive = FindInteractiveInCone(Camera->GetCameraLocation(), Camera->GetActorForwardVector(), Instance);
+			}
+			else if (bAsyncFocusTrace && RequestTraceInteractive(Camera->GetCameraLocation(), Camera->GetActorForwardVector()))
+			{
+				// focus is updated when the result comes in, see OnTraceInteractiveCompleted
+				return;
+			}
+			else
+			{
+				Interactive = TraceInteractive(Camera->GetCameraLocation(), Camera->GetActorForwardVector(), Instance);
+			}
+		}
+	}
+
+	UpdateFocus(Interactive, Instance);
+}
+
+bool UInteractionFocusComponent::GetFocusView(FVector& OutLocation, FRotator& OutRotation)
+{
+	const APlayerController* PC = GetLocalPlayerController();
+	if (PC && PC->PlayerCameraManager)
+	{
+		OutLocation = PC->PlayerCameraManager->GetCameraLocation();
+		OutRotation = PC->PlayerCameraManager->GetCameraRotation();
+		return true;
+	}
+	return false;
+}
+
+UObject* UInteractionFocusComponent::TraceInteractive(const FVector& ViewLocation, const FVector& ViewDirection, int32& OutInstance) const
+{
+	OutInstance = INDEX_NONE;
+
+	// line trace
+	FHitResult OutHit;
+	const FVector TargetPoint = ViewLocation + ViewDirection * MaxInteractionDistance;
+	const bool bHit = GetWorld()->LineTraceSingleByChannel(OutHit, ViewLocation, TargetPoint, COLLISION_INTERACTIVE, GetTraceInteractiveParams());
+	return bHit ? GetInteractiveFromHit(OutHit, OutInstance) : nullptr;
+}
+
+UObject* UInteractionFocusComponent::FindInteractiveInCone(const FVector& ViewLocation, const FVector& ViewDirection, int32& OutInstance)
+{
+	OutInstance = INDEX_NONE;
+
+	const UInteractionSubsystem* InteractionSubsystem = UInteractionSubsystem::Get(this);
+	if (InteractionSubsystem == nullptr)
+	{
+		return TraceInteractive(ViewLocation, ViewDirection, OutInstance);
+	}
+
+	TArray<UInteractiveBoxComponent*, TInlineAllocator<32>> InRange;
+	InteractionSubsystem->QueryInteractivesInRadius(ViewLocation, MaxInteractionDistance, InRange);
+
+	FocusCandidates.Reset();
+	for (UInteractiveBoxComponent* Candidate : InRange)
+	{
+		if (Candidate->GetOwner() != GetOwner())
+		{
+			FocusCandidates.Add(Candidate, Candidate->Bounds.Origin, Candidate->GetFocusPriority());
+		}
+	}
+	FocusCandidates.Score(ViewLocation, ViewDirection, MaxInteractionDistance, FocusConeAngle, FocusDistanceWeight);
+
+	// disabled candidates are skipped until an enabled one is found, checking them all first would mean a dispatch per candidate
+	int32 Best;
+	while ((Best = FocusCandidates.FindBest()) != INDEX_NONE)
+	{
+		UObject* Interactive = FocusCandidates.GetInteractive(Best);
+		const bool bInteractionDisabled = INTERACTIVE_EXECUTE(IInteractive, IsInteractionDisabled, Interactive);
+		if (bInteractionDisabled)
+		{
+			FocusCandidates.Discard(Best);
+			continue;
+		}
+
+		// the one and only trace, the interactive owner itself doesn't occlude it
+		FCollisionQueryParams OcclusionParams(SCENE_QUERY_STAT(FindInteractive), false);
+		OcclusionParams.AddIgnoredActor(GetOwner());
+		OcclusionParams.AddIgnoredActor(CastChecked<UActorComponent>(Interactive)->GetOwner());
+		const bool bOccluded = GetWorld()->LineTraceTestByChannel(ViewLocation, FocusCandidates.GetLocation(Best), ECC_Visibility, OcclusionParams);
+		FocusCandidates.Reset();
+		return bOccluded ? nullptr : Interactive;
+	}
+
+	FocusCandidates.Reset();
+	return nullptr;
+}
+
+bool UInteractionFocusComponent::RequestTraceInteractive(const FVector& ViewLocation, const FVector& ViewDirection)
+{
+	UInteractionSubsystem* InteractionSubsystem = UInteractionSubsystem::Get(this);
+	if (InteractionSubsystem == nullptr)
+	{
+		return false;
+	}
+
+	const FVector TargetPoint = ViewLocation + ViewDirection * MaxInteractionDistance;
+	InteractionSubsystem->RequestFocusTrace(this, ViewLocation, TargetPoint, GetTraceInteractiveParams(), FOnFocusTraceCompleted::CreateUObject(this, &UInteractionFocusComponent::OnTraceInteractiveCompleted));
+	return true;
+}
+
+void UInteractionFocusComponent::OnTraceInteractiveCompleted(const FHitResult* Hit)
+{
+	// the controller may have changed since the request
+	const bool bLocalController = bFocusEnabled && GetLocalPlayerController() != nullptr;
+
+	int32 Instance = INDEX_NONE;
+	UObject* Interactive = bLocalController && Hit ? GetInteractiveFromHit(*Hit, Instance) : nullptr;
+	UpdateFocus(Interactive, Instance);
+}
+
+FCollisionQueryParams UInteractionFocusComponent::GetTraceInteractiveParams() const
+{
+	FCollisionQueryParams LineParams(SCENE_QUERY_STAT(FindInteractive), true);
+	LineParams.AddIgnoredActor(GetOwner());
+	return LineParams;
+}
+
+UObject* UInteractionFocusComponent::GetInteractiveFromHit(const FHitResult& Hit, int32& OutInstance) const
+{
+	OutInstance = INDEX_NONE;
+
+	if (Hit.Component.IsValid())
+	{
+		const FInteractiveClassInfo ClassInfo = FInteractiveClassInfo::Get(Hit.Component->GetClass());
+		UObject* Interactive = Cast<UObject>(Hit.Component);
+		if (ClassInfo.bImplementsInteractive)
+		{
+			const bool bInteractionDisabled = INTERACTIVE_EXECUTE_CACHED(ClassInfo, IInteractive, IsInteractionDisabled, Interactive);
+			if (false == bInteractionDisabled)
+			{
+				return Interactive;
+			}
+		}
+		else if (ClassInfo.bImplementsInteractiveInstanced)
+		{
+			// one body per instance, the hit item is the instance
+			const IInteractiveInstanced* Instanced = CastChecked<IInteractiveInstanced>(Interactive);
+			if (Instanced->IsValidInstance(Hit.Item) && false == Instanced->IsInstanceInteractionDisabled(Hit.Item))
+			{
+				OutInstance = Hit.Item;
+				return Interactive;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+bool UInteractionFocusComponent::IsTargetInteractionDisabled(UObject* Interactive, int32 Instance)
+{
+	if (Instance != INDEX_NONE)
+	{
+		const IInteractiveInstanced* Instanced = Cast<IInteractiveInstanced>(Interactive);
+		return Instanced == nullptr || false == Instanced->IsValidInstance(Instance) || Instanced->IsInstanceInteractionDisabled(Instance);
+	}
+	return INTERACTIVE_EXECUTE(IInteractive, IsInteractionDisabled, Interactive);
+}
+
+void UInteractionFocusComponent::NotifyFocus(UObject* Interactive, int32 Instance, bool bReceived)
+{
+	if (Instance != INDEX_NONE)
+	{
+		IInteractiveInstanced* Instanced = Cast<IInteractiveInstanced>(Interactive);
+		if (Instanced && Instanced->IsValidInstance(Instance))
+		{
+			if (bReceived)
+			{
+				Instanced->OnInstanceFocusReceived(Instance, GetPlayerPawn());
+			}
+			else
+			{
+				Instanced->OnInstanceFocusLost(Instance, GetPlayerPawn());
+			}
+		}
+	}
+	else if (bReceived)
+	{
+		INTERACTIVE_EXECUTE(IInteractive, OnFocusReceived, Interactive, GetPlayerPawn());
+	}
+	else
+	{
+		INTERACTIVE_EXECUTE(IInteractive, OnFocusLost, Interactive, GetPlayerPawn());
+	}
+}
+
+void UInteractionFocusComponent::UpdateFocus(UObject* Interactive, int32 Instance)
+{
+	if (Interactive != CurrentInteractive || Instance != CurrentInstance)
+	{
+		// update cached value, call focus events
+		if (Interactive != nullptr)
+		{
+			NotifyFocus(Interactive, Instance, true);
+		}
+		if (CurrentInteractive.IsValid())
+		{
+			// force stop interaction on focus lost, should refactor this if we want to keep the interaction active (maybe by adding a new method "ShouldStopInteraction" in IInteractive interface)
+			GetPlayerPawn()->StopInteraction(CurrentInteractive.Get(), CurrentInstance);
+			NotifyFocus(CurrentInteractive.Get(), CurrentInstance, false);
+		}
+		SetCurrentInteractive(Interactive, Instance);
+		
+	}
+}
+
+void UInteractionFocusComponent::SetCurrentInteractive(UObject* Interactive, int32 Instance)
+{
+	IInteractive* OldInteractive = Cast<IInteractive>(CurrentInteractive.Get());
+	if (OldInteractive && OldInteractive->GetOnInteractionAvailabilityChanged())
+	{
+		OldInteractive->GetOnInteractionAvailabilityChanged()->Remove(InteractionAvailabilityChangedHandle);
+	}
+	if (OldInteractive && OldInteractive->GetOnInteractionStateChanged())
+	{
+		OldInteractive->GetOnInteractionStateChanged()->Remove(InteractionStateChangedHandle);
+	}
+	IInteractiveInstanced* OldInstanced = Cast<IInteractiveInstanced>(CurrentInteractive.Get());
+	if (OldInstanced && OldInstanced->GetOnInstanceInteractionAvailabilityChanged())
+	{
+		OldInstanced->GetOnInstanceInteractionAvailabilityChanged()->Remove(InteractionAvailabilityChangedHandle);
+	}
+	if (OldInstanced && OldInstanced->GetOnInstanceInteractionStateChanged())
+	{
+		OldInstanced->GetOnInstanceInteractionStateChanged()->Remove(InteractionStateChangedHandle);
+	}
+	InteractionAvailabilityChangedHandle.Reset();
+	InteractionStateChangedHandle.Reset();
+
+	const bool bFocusChanged = Interactive != CurrentInteractive.Get() || Instance != CurrentInstance;
+	CurrentInteractive = Interactive;
+	CurrentInstance = Interactive ? Instance : INDEX_NONE;
+
+	// event driven focus drop, see OnInteractionAvailabilityChanged
+	IInteractive* NewInteractive = Cast<IInteractive>(Interactive);
+	if (NewInteractive && NewInteractive->GetOnInteractionAvailabilityChanged())
+	{
+		InteractionAvailabilityChangedHandle = NewInteractive->GetOnInteractionAvailabilityChanged()->AddUObject(this, &UInteractionFocusComponent::OnInteractionAvailabilityChanged);
+	}
+	// event driven message, see OnInteractionStateChanged
+	if (NewInteractive && NewInteractive->GetOnInteractionStateChanged())
+	{
+		InteractionStateChangedHandle = NewInteractive->GetOnInteractionStateChanged()->AddUObject(this, &UInteractionFocusComponent::OnInteractionStateChanged);
+	}
+	// same for instanced interactives, whose notifications tell the instance
+	IInteractiveInstanced* NewInstanced = Cast<IInteractiveInstanced>(Interactive);
+	if (NewInstanced && NewInstanced->GetOnInstanceInteractionAvailabilityChanged())
+	{
+		InteractionAvailabilityChangedHandle = NewInstanced->GetOnInstanceInteractionAvailabilityChanged()->AddUObject(this, &UInteractionFocusComponent::OnInstanceInteractionAvailabilityChanged);
+	}
+	if (NewInstanced && NewInstanced->GetOnInstanceInteractionStateChanged())
+	{
+		InteractionStateChangedHandle = NewInstanced->GetOnInstanceInteractionStateChanged()->AddUObject(this, &UInteractionFocusComponent::OnInstanceInteractionStateChanged);
+	}
+
+	// fallback for interactives that may not notify their state changes, see IInteractive::ShouldPollInteractionState
+	if (UWorld* World = GetWorld())
+	{
+		FTimerManager& TimerManager = World->GetTimerManager();
+		if (Interactive && ShouldPollTargetState(Interactive, CurrentInstance))
+		{
+			if (false == TimerManager.IsTimerActive(TimerHandle_PollInteractionState))
+			{
+				TimerManager.SetTimer(TimerHandle_PollInteractionState, this, &UInteractionFocusComponent::PollInteractionState, InteractionStatePollInterval, true);
+			}
+		}
+		else
+		{
+			TimerManager.ClearTimer(TimerHandle_PollInteractionState);
+		}
+	}
+
+	UpdateInteractionMessage(bFocusChanged);
+}
+
+bool UInteractionFocusComponent::ShouldPollTargetState(UObject* Interactive, int32 Instance)
+{
+	if (Instance != INDEX_NONE)
+	{
+		const IInteractiveInstanced* Instanced = Cast<IInteractiveInstanced>(Interactive);
+		return Instanced && Instanced->ShouldPollInstanceState();
+	}
+	// blueprint implementations of IInteractive have no native notifications at all
+	const IInteractive* NativeInteractive = Cast<IInteractive>(Interactive);
+	return NativeInteractive == nullptr || NativeInteractive->ShouldPollInteractionState();
+}
+
+void UInteractionFocusComponent::PollInteractionState()
+{
+	// drops focus if disabled, or refreshes the message
+	TryStopInteraction();
+	UpdateInteractionMessage();
+}
+
+void UInteractionFocusComponent::OnInteractionAvailabilityChanged(UObject* Interactive, bool bDisabled)
+{
+	if (bDisabled && Interactive == CurrentInteractive.Get())
+	{
+		// drop focus on the same frame interaction gets disabled
+		TryStopInteraction();
+	}
+}
+
+void UInteractionFocusComponent::OnInteractionStateChanged(UObject* Interactive)
+{
+	if (Interactive == CurrentInteractive.Get())
+	{
+		UpdateInteractionMessage();
+	}
+}
+
+void UInteractionFocusComponent::OnInstanceInteractionAvailabilityChanged(UObject* Interactive, int32 Instance, bool bDisabled)
+{
+	if (bDisabled && Interactive == CurrentInteractive.Get() && Instance == CurrentInstance)
+	{
+		TryStopInteraction();
+	}
+}
+
+void UInteractionFocusComponent::OnInstanceInteractionStateChanged(UObject* Interactive, int32 Instance)
+{
+	if (Interactive == CurrentInteractive.Get() && Instance == CurrentInstance)
+	{
+		UpdateInteractionMessage();
+	}
+}
+
+void UInteractionFocusComponent::UpdateInteractionMessage(bool bFocusChanged)
+{
+	UObject* Interactive = CurrentInteractive.Get();
+
+	// interactives that can't notify state changes get the message computed on focus and on poll, see PollInteractionState
+	FText NewMessage = FText::GetEmpty();
+	if (Interactive && CurrentInstance != INDEX_NONE)
+	{
+		const IInteractiveInstanced* Instanced = Cast<IInteractiveInstanced>(Interactive);
+		if (Instanced && Instanced->IsValidInstance(CurrentInstance))
+		{
+			NewMessage = Instanced->GetInstanceMessage(CurrentInstance, GetPlayerPawn());
+		}
+	}
+	else if (Interactive)
+	{
+		NewMessage = INTERACTIVE_EXECUTE(IInteractive, GetMessage, Interactive, GetPlayerPawn());
+	}
+	if (bFocusChanged || (false == NewMessage.IdenticalTo(InteractionMessage) && false == NewMessage.EqualTo(InteractionMessage)))
+	{
+		InteractionMessage = NewMessage;
+		OnInteractionMessageChanged.Broadcast(Interactive, InteractionMessage);
+	}
+}
+
+const FText& UInteractionFocusComponent::GetInteractionMessage() const
+{
+	return InteractionMessage;
+}
+
+void UInteractionFocusComponent::TryStopInteraction()
+{
+	INTERACTION_SCOPE_CYCLE_COUNTER(TryStopInteraction);
+
+	if (CurrentInteractive.IsValid())
+	{
+		const bool bInteractionDisabled = IsTargetInteractionDisabled(CurrentInteractive.Get(), CurrentInstance);
+		if (bInteractionDisabled)
+		{
+			GetPlayerPawn()->StopInteraction(CurrentInteractive.Get(), CurrentInstance);
+			NotifyFocus(CurrentInteractive.Get(), CurrentInstance, false);
+			SetCurrentInteractive(nullptr);
+		}
+	}
+
+}
+
+UObject* UInteractionFocusComponent::GetCurrentInteractive() const
+{
+	return CurrentInteractive.IsValid() ? CurrentInteractive.Get() : nullptr;
+}
+
+int32 UInteractionFocusComponent::GetCurrentInstance() const
+{
+	return CurrentInteractive.IsValid() ? CurrentInstance : INDEX_NONE;
+}
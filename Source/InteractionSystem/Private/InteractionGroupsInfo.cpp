@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractionGroupsInfo.h"
+#include "InteractionSystem.h"
+#include "InteractionSubsystem.h"
+#include "Net/UnrealNetwork.h"
+
+AInteractionGroupsInfo::AInteractionGroupsInfo()
+{
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	// changes are rare, and pushed with ForceNetUpdate
+	NetUpdateFrequency = 1.f;
+}
+
+void AInteractionGroupsInfo::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// on clients this is how the subsystem gets the replicated table, before the initial rep notifies
+	if (UInteractionSubsystem* InteractionSubsystem = UInteractionSubsystem::Get(this))
+	{
+		InteractionSubsystem->SetInteractionGroupsInfo(this);
+	}
+}
+
+void AInteractionGroupsInfo::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UInteractionSubsystem* InteractionSubsystem = UInteractionSubsystem::Get(this))
+	{
+		InteractionSubsystem->SetInteractionGroupsInfo(nullptr, this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+int32 AInteractionGroupsInfo::FindOrAddGroup(FName Group)
+{
+	check(HasAuthority());
+
+	int32 GroupIndex = GroupNames.IndexOfByKey(Group);
+	if (GroupIndex == INDEX_NONE && Group != NAME_None)
+	{
+		GroupIndex = GroupNames.Add(Group);
+		INTERACTION_MARK_PROPERTY_DIRTY(AInteractionGroupsInfo, GroupNames, this);
+		ForceNetUpdate();
+	}
+	return GroupIndex;
+}
+
+void AInteractionGroupsInfo::SetGroupDisabled(int32 GroupIndex, bool bDisabled)
+{
+	check(HasAuthority());
+
+	if (GroupIndex < 0 || IsGroupDisabled(GroupIndex) == bDisabled)
+	{
+		return;
+	}
+
+	const TArray<uint32> OldDisabledGroupBits = DisabledGroupBits;
+
+	const int32 Word = GroupIndex >> 5;
+	if (Word >= DisabledGroupBits.Num())
+	{
+		DisabledGroupBits.SetNumZeroed(Word + 1);
+	}
+	const uint32 Bit = 1u << (GroupIndex & 31);
+	DisabledGroupBits[Word] = bDisabled ? (DisabledGroupBits[Word] | Bit) : (DisabledGroupBits[Word] & ~Bit);
+
+	INTERACTION_MARK_PROPERTY_DIRTY(AInteractionGroupsInfo, DisabledGroupBits, this);
+	ForceNetUpdate();
+
+	NotifyGroupsChanged(OldDisabledGroupBits);
+}
+
+void AInteractionGroupsInfo::OnRep_DisabledGroupBits(const TArray<uint32>& OldDisabledGroupBits)
+{
+	NotifyGroupsChanged(OldDisabledGroupBits);
+}
+
+void AInteractionGroupsInfo::NotifyGroupsChanged(const TArray<uint32>& OldDisabledGroupBits)
+{
+	UInteractionSubsystem* InteractionSubsystem = UInteractionSubsystem::Get(this);
+	if (InteractionSubsystem == nullptr)
+	{
+		return;
+	}
+
+	const int32 NumWords = FMath::Max(OldDisabledGroupBits.Num(), DisabledGroupBits.Num());
+	TArray<uint32> ChangedGroupBits;
+	ChangedGroupBits.SetNumZeroed(NumWords);
+	bool bChanged = false;
+	for (int32 Word = 0; Word < NumWords; ++Word)
+	{
+		const uint32 OldBits = OldDisabledGroupBits.IsValidIndex(Word) ? OldDisabledGroupBits[Word] : 0;
+		const uint32 NewBits = DisabledGroupBits.IsValidIndex(Word) ? DisabledGroupBits[Word] : 0;
+		ChangedGroupBits[Word] = OldBits ^ NewBits;
+		bChanged |= ChangedGroupBits[Word] != 0;
+	}
+
+	if (bChanged)
+	{
+		InteractionSubsystem->NotifyInteractionGroupsChanged(ChangedGroupBits);
+	}
+}
+
+void AInteractionGroupsInfo::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+#if WITH_INTERACTION_PUSH_MODEL
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AInteractionGroupsInfo, GroupNames, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AInteractionGroupsInfo, DisabledGroupBits, Params);
+#else
+	DOREPLIFETIME(AInteractionGroupsInfo, GroupNames);
+	DOREPLIFETIME(AInteractionGroupsInfo, DisabledGroupBits);
+#endif
+}
@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractionHUDWidget.h"
+#include "InteractionFocusComponent.h"
+#include "PlayerPawn.h"
+#include "Blueprint/WidgetTree.h"
+#include "Components/CanvasPanel.h"
+#include "Components/CanvasPanelSlot.h"
+#include "Components/TextBlock.h"
+#include "GameFramework/PlayerController.h"
+
+#define LOCTEXT_NAMESPACE "InteractionSystem"
+
+bool UInteractionHUDWidget::Initialize()
+{
+	const bool bInitializedNow = Super::Initialize();
+
+	if (bInitializedNow && WidgetTree && WidgetTree->RootWidget == nullptr)
+	{
+		BuildDefaultWidgetTree();
+	}
+
+	return bInitializedNow;
+}
+
+void UInteractionHUDWidget::BuildDefaultWidgetTree()
+{
+	UCanvasPanel* Canvas = WidgetTree->ConstructWidget<UCanvasPanel>(UCanvasPanel::StaticClass(), TEXT("Canvas"));
+	WidgetTree->RootWidget = Canvas;
+
+	// centered below the crosshair
+	Text_Interaction = WidgetTree->ConstructWidget<UTextBlock>(UTextBlock::StaticClass(), TEXT("Text_Interaction"));
+	Text_Interaction->SetJustification(ETextJustify::Center);
+	UCanvasPanelSlot* InteractionSlot = Canvas->AddChildToCanvas(Text_Interaction);
+	InteractionSlot->SetAnchors(FAnchors(0.5f));
+	InteractionSlot->SetAlignment(FVector2D(0.5f, 0.f));
+	InteractionSlot->SetPosition(FVector2D(0.f, 32.f));
+	InteractionSlot->SetAutoSize(true);
+
+	// top left corner
+	Text_NetMode = WidgetTree->ConstructWidget<UTextBlock>(UTextBlock::StaticClass(), TEXT("Text_NetMode"));
+	UCanvasPanelSlot* NetModeSlot = Canvas->AddChildToCanvas(Text_NetMode);
+	NetModeSlot->SetPosition(FVector2D(16.f, 16.f));
+	NetModeSlot->SetAutoSize(true);
+}
+
+void UInteractionHUDWidget::NativeConstruct()
+{
+	Super::NativeConstruct();
+
+	const APlayerController* PC = GetOwningPlayer();
+	if (Text_NetMode)
+	{
+		Text_NetMode->SetText(PC && PC->HasAuthority() ? LOCTEXT("HUDNetModeServer", "Server") : LOCTEXT("HUDNetModeClient", "Client"));
+	}
+
+	// the possessed pawn may change while the HUD lives, and may already have its focus enabled
+	FocusEnabledChangedHandle = UInteractionFocusComponent::OnFocusEnabledChanged.AddUObject(this, &UInteractionHUDWidget::OnFocusEnabledChanged);
+
+	APlayerPawn* PlayerPawn = Cast<APlayerPawn>(GetOwningPlayerPawn());
+	UInteractionFocusComponent* PawnInteractionFocus = PlayerPawn ? PlayerPawn->GetInteractionFocus() : nullptr;
+	BindInteractionFocus(PawnInteractionFocus && PawnInteractionFocus->IsFocusEnabled() ? PawnInteractionFocus : nullptr);
+}
+
+void UInteractionHUDWidget::NativeDestruct()
+{
+	UInteractionFocusComponent::OnFocusEnabledChanged.Remove(FocusEnabledChangedHandle);
+	FocusEnabledChangedHandle.Reset();
+
+	BindInteractionFocus(nullptr);
+
+	Super::NativeDestruct();
+}
+
+void UInteractionHUDWidget::BindInteractionFocus(UInteractionFocusComponent* NewInteractionFocus)
+{
+	if (InteractionFocus.Get() == NewInteractionFocus)
+	{
+		return;
+	}
+
+	if (InteractionFocus.IsValid())
+	{
+		InteractionFocus->OnInteractionMessageChanged.RemoveDynamic(this, &UInteractionHUDWidget::OnInteractionMessageChanged);
+	}
+
+	InteractionFocus = NewInteractionFocus;
+
+	if (NewInteractionFocus)
+	{
+		NewInteractionFocus->OnInteractionMessageChanged.AddDynamic(this, &UInteractionHUDWidget::OnInteractionMessageChanged);
+	}
+
+	// current message, the next ones come with OnInteractionMessageChanged
+	OnInteractionMessageChanged(nullptr, NewInteractionFocus ? NewInteractionFocus->GetInteractionMessage() : FText::GetEmpty());
+}
+
+void UInteractionHUDWidget::OnFocusEnabledChanged(UInteractionFocusComponent* FocusComponent, bool bEnabled)
+{
+	if (bEnabled)
+	{
+		// only the pawn possessed by the owning player, there is a focus per local player in split screen
+		const APawn* Pawn = Cast<APawn>(FocusComponent->GetOwner());
+		if (Pawn && Pawn->GetController() == GetOwningPlayer())
+		{
+			BindInteractionFocus(FocusComponent);
+		}
+	}
+	else if (FocusComponent == InteractionFocus.Get())
+	{
+		BindInteractionFocus(nullptr);
+	}
+}
+
+void UInteractionHUDWidget::OnInteractionMessageChanged(UObject* Interactive, const FText& Message)
+{
+	if (Text_Interaction)
+	{
+		Text_Interaction->SetText(Message);
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,202 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractionReplicationGraph.h"
+#include "InteractiveDispatch.h"
+#include "InteractionSystem.h"
+#include "Components/ActorComponent.h"
+#include "Components/SceneComponent.h"
+#include "GameFramework/Actor.h"
+
+UReplicationGraphNode_InteractiveActors::UReplicationGraphNode_InteractiveActors()
+{
+	bRequiresPrepareForReplicationCall = true;
+	CellSize = 2000.f;
+	Radius = 3000.f;
+}
+
+FIntPoint UReplicationGraphNode_InteractiveActors::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+void UReplicationGraphNode_InteractiveActors::AddToCell(AActor* Actor, const FIntPoint& Cell)
+{
+	FActorRepListRefView* List = Cells.Find(Cell);
+	if (List == nullptr)
+	{
+		List = &Cells.Add(Cell);
+		List->PrepareForWrite();
+	}
+	List->Add(Actor);
+}
+
+void UReplicationGraphNode_InteractiveActors::RemoveFromCell(AActor* Actor, const FIntPoint& Cell)
+{
+	FActorRepListRefView* List = Cells.Find(Cell);
+	if (List)
+	{
+		List->Remove(Actor);
+	}
+}
+
+void UReplicationGraphNode_InteractiveActors::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	AActor* Actor = ActorInfo.Actor;
+	if (EntryIndices.Contains(Actor))
+	{
+		return;
+	}
+
+	FInteractiveActorEntry Entry;
+	Entry.Actor = Actor;
+	Entry.Cell = GetCell(Actor->GetActorLocation());
+	Entry.bMovable = Actor->GetRootComponent() && Actor->GetRootComponent()->Mobility != EComponentMobility::Static;
+	EntryIndices.Add(Actor, Entries.Add(Entry));
+
+	AddToCell(Actor, Entry.Cell);
+}
+
+bool UReplicationGraphNode_InteractiveActors::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	int32 Index;
+	if (false == EntryIndices.RemoveAndCopyValue(ActorInfo.Actor, Index))
+	{
+		UE_CLOG(bWarnIfNotFound, LogInteraction, Warning, TEXT("UReplicationGraphNode_InteractiveActors::NotifyRemoveNetworkActor: %s not found"), *GetNameSafe(ActorInfo.Actor));
+		return false;
+	}
+
+	RemoveFromCell(ActorInfo.Actor, Entries[Index].Cell);
+
+	// the last entry takes the removed slot
+	Entries.RemoveAtSwap(Index, 1, false);
+	if (Entries.IsValidIndex(Index))
+	{
+		EntryIndices[Entries[Index].Actor] = Index;
+	}
+	return true;
+}
+
+void UReplicationGraphNode_InteractiveActors::NotifyResetAllNetworkActors()
+{
+	Entries.Reset();
+	EntryIndices.Reset();
+	Cells.Reset();
+}
+
+void UReplicationGraphNode_InteractiveActors::PrepareForReplication()
+{
+	// interactive actors rarely move (e.g. movers), update the cell of movable ones only
+	for (FInteractiveActorEntry& Entry : Entries)
+	{
+		if (Entry.bMovable)
+		{
+			const FIntPoint Cell = GetCell(Entry.Actor->GetActorLocation());
+			if (Cell != Entry.Cell)
+			{
+				RemoveFromCell(Entry.Actor, Entry.Cell);
+				AddToCell(Entry.Actor, Cell);
+				Entry.Cell = Cell;
+			}
+		}
+	}
+}
+
+void UReplicationGraphNode_InteractiveActors::GatherCells(const FVector& ViewLocation, const FConnectionGatherActorListParameters& Params, TArray<FIntPoint, TInlineAllocator<16>>& GatheredCells)
+{
+	const FIntPoint MinCell = GetCell(ViewLocation - FVector(Radius, Radius, 0.f));
+	const FIntPoint MaxCell = GetCell(ViewLocation + FVector(Radius, Radius, 0.f));
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			const FIntPoint Cell(X, Y);
+			const FActorRepListRefView* List = Cells.Find(Cell);
+			if (List && List->Num() > 0 && false == GatheredCells.Contains(Cell))
+			{
+				GatheredCells.Add(Cell);
+				Params.OutGatheredReplicationLists.AddReplicationActorList(*List);
+			}
+		}
+	}
+}
+
+void UReplicationGraphNode_InteractiveActors::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	TArray<FIntPoint, TInlineAllocator<16>> GatheredCells;
+
+#if ENGINE_MAJOR_VERSION > 4 || ENGINE_MINOR_VERSION >= 24
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		GatherCells(Viewer.ViewLocation, Params, GatheredCells);
+	}
+#else
+	GatherCells(Params.Viewer.ViewLocation, Params, GatheredCells);
+#endif
+}
+
+UInteractionReplicationGraph::UInteractionReplicationGraph()
+{
+	InteractiveRelevancyRadius = 3000.f;
+	InteractiveCellSize = 2000.f;
+	InteractiveActorsNode = nullptr;
+}
+
+void UInteractionReplicationGraph::InitGlobalGraphNodes()
+{
+	Super::InitGlobalGraphNodes();
+
+	InteractiveActorsNode = CreateNewNode<UReplicationGraphNode_InteractiveActors>();
+	InteractiveActorsNode->CellSize = FMath::Max(InteractiveCellSize, 1.f);
+	InteractiveActorsNode->Radius = InteractiveRelevancyRadius;
+	AddGlobalGraphNode(InteractiveActorsNode);
+}
+
+void UInteractionReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	if (IsInteractiveActor(ActorInfo.Actor))
+	{
+		// relevant within radius, even if the actor is set to always relevant
+		GlobalInfo.Settings.CullDistanceSquared = FMath::Square(InteractiveRelevancyRadius);
+		InteractiveActorsNode->NotifyAddNetworkActor(ActorInfo);
+		return;
+	}
+
+	Super::RouteAddNetworkActorToNodes(ActorInfo, GlobalInfo);
+}
+
+void UInteractionReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	// components may be already gone here, so just try the interactive node first
+	if (InteractiveActorsNode->NotifyRemoveNetworkActor(ActorInfo, false))
+	{
+		return;
+	}
+
+	Super::RouteRemoveNetworkActorToNodes(ActorInfo);
+}
+
+bool UInteractionReplicationGraph::IsInteractiveActor(const AActor* Actor)
+{
+	if (Actor == nullptr || Actor->bOnlyRelevantToOwner)
+	{
+		return false;
+	}
+
+	for (const UActorComponent* Component : Actor->GetComponents())
+	{
+		if (Component == nullptr)
+		{
+			continue;
+		}
+
+		// instanced interactives included, e.g. UInteractiveInstancedBoxComponent
+		const FInteractiveClassInfo ClassInfo = FInteractiveClassInfo::Get(Component->GetClass());
+		if (ClassInfo.bImplementsInteractive || ClassInfo.bImplementsInteractiveInstanced)
+		{
+			return true;
+		}
+	}
+	return false;
+}
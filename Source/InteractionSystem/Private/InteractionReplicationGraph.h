@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BasicReplicationGraph.h"
+#include "InteractionReplicationGraph.generated.h"
+
+/**
+* Spatialized node for actors owning interactive components.
+* Actors are bucketed in a 2D grid, and each connection gathers the cells within InteractiveRelevancyRadius of its viewer only.
+* The exact radius is then checked by the graph through the actor cull distance (see UInteractionReplicationGraph::RouteAddNetworkActorToNodes).
+*/
+UCLASS()
+class UReplicationGraphNode_InteractiveActors : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+
+	UReplicationGraphNode_InteractiveActors();
+
+	//~ Begin UReplicationGraphNode Interface
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+	virtual void PrepareForReplication() override;
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+	//~ End UReplicationGraphNode Interface
+
+	float CellSize;
+
+	float Radius;
+
+private:
+
+	struct FInteractiveActorEntry
+	{
+		AActor* Actor;
+		FIntPoint Cell;
+		bool bMovable;
+	};
+
+	TArray<FInteractiveActorEntry> Entries;
+
+	// index of each actor in Entries, so that removal is not a linear search
+	TMap<AActor*, int32> EntryIndices;
+
+	TMap<FIntPoint, FActorRepListRefView> Cells;
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	void AddToCell(AActor* Actor, const FIntPoint& Cell);
+
+	void RemoveFromCell(AActor* Actor, const FIntPoint& Cell);
+
+	void GatherCells(const FVector& ViewLocation, const FConnectionGatherActorListParameters& Params, TArray<FIntPoint, TInlineAllocator<16>>& GatheredCells);
+};
+
+/**
+* Replication graph for the interaction system, enabled in DefaultEngine.ini (ReplicationDriverClassName).
+* Same as UBasicReplicationGraph, except for actors owning interactive components (instanced ones included): instead of being always relevant,
+* they are relevant to a connection only when they are within InteractiveRelevancyRadius of that player's pawn (viewer),
+* so server replication cost scales with local density, not with the total number of interactables.
+*/
+UCLASS(Transient, Config = Engine)
+class UInteractionReplicationGraph : public UBasicReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+
+	UInteractionReplicationGraph();
+
+	//~ Begin UReplicationGraph Interface
+	virtual void InitGlobalGraphNodes() override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+	//~ End UReplicationGraph Interface
+
+	/**
+	* actors owning interactive components are relevant to players within this distance
+	*/
+	UPROPERTY(Config)
+	float InteractiveRelevancyRadius;
+
+	/**
+	* grid cell size of the interactive actors node
+	*/
+	UPROPERTY(Config)
+	float InteractiveCellSize;
+
+	UPROPERTY()
+	UReplicationGraphNode_InteractiveActors* InteractiveActorsNode;
+
+	/**
+	* does actor own a component implementing IInteractive?
+	*/
+	static bool IsInteractiveActor(const AActor* Actor);
+};
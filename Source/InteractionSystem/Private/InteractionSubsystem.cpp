@@ -0,0 +1,868 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractionSubsystem.h"
+#include "InteractionSystem.h"
+#include "InteractiveBoxComponent.h"
+#include "InteractionGroupsInfo.h"
+#include "InteractiveLevelIndex.h"
+#include "InteractionFocusCandidates.h"
+#include "Interactive.h"
+#include "Async/ParallelFor.h"
+#include "Engine/GameInstance.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/Engine.h"
+
+FInteractionAgentQuery::FInteractionAgentQuery()
+	: Agent(nullptr)
+	, Location(FVector::ZeroVector)
+	, Direction(FVector::ForwardVector)
+	, Reach(150.f)
+	, ConeHalfAngle(60.f)
+{}
+
+UInteractionSubsystem::UInteractionSubsystem()
+	: FocusLocationThreshold(2.f)
+	, FocusAngleThreshold(0.5f)
+	, FocusMaxInterval(0.5f)
+	, MaxFocusUpdatesPerFrame(8)
+	, RegistryCellSize(1000.f)
+	, TimerWheelResolution(1.f / 30.f)
+	, LevelIndexEntriesPerFrame(256)
+	, RequesterRateLimitBurst(10.f)
+	, RequesterRateLimitRate(5.f)
+	, InteractiveRateLimitBurst(20.f)
+	, InteractiveRateLimitRate(10.f)
+	, InteractionGroupsInfo(nullptr)
+	, NextFocusTraceId(0)
+	, LastBucketsPruneTime(0.0)
+	, NumDroppedByRequester(0)
+	, NumDroppedByInteractive(0)
+{
+}
+
+UInteractionSubsystem* UInteractionSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UInteractionSubsystem>() : nullptr;
+}
+
+void UInteractionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FocusTraceDelegate.BindUObject(this, &UInteractionSubsystem::OnFocusTraceDone);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UInteractionSubsystem::OnWorldPostActorTick);
+
+	// config is loaded by now
+	TimerWheel.Reset(TimerWheelResolution);
+}
+
+void UInteractionSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	PostActorTickHandle.Reset();
+
+	PendingFocusTraces.Reset();
+	InFlightFocusTraces.Reset();
+	FocusSources.Reset();
+	ChangedInteractiveBounds.Reset();
+
+	EntryBounds.Reset();
+	EntryCells.Reset();
+	PendingLevelIndices.Reset();
+	EntryComponents.Reset();
+	EntryPriorities.Reset();
+	EntryIndices.Reset();
+	Cells.Reset();
+	OversizedEntries.Reset();
+
+	InteractionGroupsInfo = nullptr;
+	FocusTraceDelegate.Unbind();
+
+	TimerWheel.Reset(TimerWheelResolution);
+	SET_DWORD_STAT(STAT_InteractionTimers, 0);
+
+	RequesterBuckets.Reset();
+	InteractiveBuckets.Reset();
+
+	Super::Deinitialize();
+}
+
+void UInteractionSubsystem::RequestFocusTrace(const UObject* Requester, const FVector& Start, const FVector& End, const FCollisionQueryParams& Params, FOnFocusTraceCompleted&& Callback)
+{
+	check(Requester);
+
+	FFocusTraceRequest* Request = PendingFocusTraces.FindByPredicate([Requester](const FFocusTraceRequest& Pending) { return Pending.Requester == Requester; });
+	if (Request == nullptr)
+	{
+		Request = &PendingFocusTraces.AddDefaulted_GetRef();
+		Request->Requester = Requester;
+	}
+
+	Request->World = Requester->GetWorld();
+	Request->Start = Start;
+	Request->End = End;
+	Request->Params = Params;
+	Request->Callback = MoveTemp(Callback);
+}
+
+void UInteractionSubsystem::CancelFocusTrace(const UObject* Requester)
+{
+	PendingFocusTraces.RemoveAll([Requester](const FFocusTraceRequest& Pending) { return Pending.Requester == Requester; });
+
+	for (auto It = InFlightFocusTraces.CreateIterator(); It; ++It)
+	{
+		if (It.Value().Requester == Requester)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+UInteractionSubsystem::FTokenBucket& UInteractionSubsystem::RefillBucket(TMap<TWeakObjectPtr<const UObject>, FTokenBucket>& Buckets, const UObject* Key, double Now, float Burst, float Rate)
+{
+	FTokenBucket* Bucket = Buckets.Find(Key);
+	if (Bucket == nullptr)
+	{
+		Bucket = &Buckets.Add(Key);
+		Bucket->Tokens = Burst;
+	}
+	else
+	{
+		Bucket->Tokens = FMath::Min(Burst, Bucket->Tokens + float(Now - Bucket->LastRefillTime) * Rate);
+	}
+	Bucket->LastRefillTime = Now;
+	return *Bucket;
+}
+
+bool UInteractionSubsystem::ConsumeInteractRequest(const UObject* Requester, const UObject* Target)
+{
+	const UWorld* World = GetGameInstance()->GetWorld();
+	if (World == nullptr)
+	{
+		return true;
+	}
+
+	// real time, so that pause or time dilation don't change the limits
+	const double Now = World->GetRealTimeSeconds();
+	if (Now - LastBucketsPruneTime > 10.0)
+	{
+		PruneBuckets(Now);
+	}
+
+	// both buckets must have a token, a request dropped by one doesn't cost a token of the other
+	FTokenBucket* RequesterBucket = RequesterRateLimitRate > 0.f ? &RefillBucket(RequesterBuckets, Requester, Now, FMath::Max(RequesterRateLimitBurst, 1.f), RequesterRateLimitRate) : nullptr;
+	if (RequesterBucket && RequesterBucket->Tokens < 1.f)
+	{
+		++NumDroppedByRequester;
+		INC_DWORD_STAT(STAT_DroppedInteractRequests);
+		CSV_CUSTOM_STAT(Interaction, DroppedInteractRequests, 1, ECsvCustomStatOp::Accumulate);
+		UE_LOG(LogInteraction, Verbose, TEXT("Interact request of %s dropped, requester rate limit"), *GetNameSafe(Requester));
+		return false;
+	}
+
+	FTokenBucket* InteractiveBucket = Target && InteractiveRateLimitRate > 0.f ? &RefillBucket(InteractiveBuckets, Target, Now, FMath::Max(InteractiveRateLimitBurst, 1.f), InteractiveRateLimitRate) : nullptr;
+	if (InteractiveBucket && InteractiveBucket->Tokens < 1.f)
+	{
+		++NumDroppedByInteractive;
+		INC_DWORD_STAT(STAT_DroppedInteractRequests);
+		CSV_CUSTOM_STAT(Interaction, DroppedInteractRequests, 1, ECsvCustomStatOp::Accumulate);
+		UE_LOG(LogInteraction, Verbose, TEXT("Interact request on %s dropped, interactive rate limit"), *GetNameSafe(Target));
+		return false;
+	}
+
+	if (RequesterBucket)
+	{
+		RequesterBucket->Tokens -= 1.f;
+	}
+	if (InteractiveBucket)
+	{
+		InteractiveBucket->Tokens -= 1.f;
+	}
+	return true;
+}
+
+void UInteractionSubsystem::PruneBuckets(double Now)
+{
+	LastBucketsPruneTime = Now;
+
+	auto Prune = [Now](TMap<TWeakObjectPtr<const UObject>, FTokenBucket>& Buckets, float Burst, float Rate)
+	{
+		for (auto It = Buckets.CreateIterator(); It; ++It)
+		{
+			// a refilled bucket is the same as no bucket
+			if (false == It.Key().IsValid() || It.Value().Tokens + float(Now - It.Value().LastRefillTime) * Rate >= Burst)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	};
+	Prune(RequesterBuckets, FMath::Max(RequesterRateLimitBurst, 1.f), RequesterRateLimitRate);
+	Prune(InteractiveBuckets, FMath::Max(InteractiveRateLimitBurst, 1.f), InteractiveRateLimitRate);
+}
+
+void UInteractionSubsystem::SetInteractionGroupDisabled(FName Group, bool bDisabled)
+{
+	UWorld* World = GetGameInstance()->GetWorld();
+	if (World == nullptr || World->GetNetMode() == NM_Client)
+	{
+		UE_LOG(LogInteraction, Warning, TEXT("SetInteractionGroupDisabled %s: server only"), *Group.ToString());
+		return;
+	}
+
+	if (InteractionGroupsInfo == nullptr)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		InteractionGroupsInfo = World->SpawnActor<AInteractionGroupsInfo>(SpawnParams);
+	}
+
+	if (InteractionGroupsInfo)
+	{
+		InteractionGroupsInfo->SetGroupDisabled(InteractionGroupsInfo->FindOrAddGroup(Group), bDisabled);
+	}
+}
+
+bool UInteractionSubsystem::IsInteractionGroupDisabled(FName Group) const
+{
+	return IsInteractionGroupDisabled(FindInteractionGroup(Group));
+}
+
+int32 UInteractionSubsystem::FindInteractionGroup(FName Group) const
+{
+	return InteractionGroupsInfo && Group != NAME_None ? InteractionGroupsInfo->FindGroup(Group) : INDEX_NONE;
+}
+
+bool UInteractionSubsystem::IsInteractionGroupDisabled(int32 GroupIndex) const
+{
+	return InteractionGroupsInfo && InteractionGroupsInfo->IsGroupDisabled(GroupIndex);
+}
+
+void UInteractionSubsystem::SetInteractionGroupsInfo(AInteractionGroupsInfo* GroupsInfo, AInteractionGroupsInfo* Expected)
+{
+	if (GroupsInfo || InteractionGroupsInfo == Expected)
+	{
+		InteractionGroupsInfo = GroupsInfo;
+	}
+}
+
+void UInteractionSubsystem::NotifyInteractionGroupsChanged(const TArray<uint32>& ChangedGroupBits)
+{
+	// copy, notifications may unregister interactives
+	const TArray<UInteractiveBoxComponent*> Interactives = EntryComponents;
+	for (UInteractiveBoxComponent* Interactive : Interactives)
+	{
+		const int32 GroupIndex = Interactive->GetInteractionGroupIndex();
+		const int32 Word = GroupIndex >> 5;
+		if (GroupIndex != INDEX_NONE && Word < ChangedGroupBits.Num() && (ChangedGroupBits[Word] & (1u << (GroupIndex & 31))) != 0)
+		{
+			Interactive->NotifyInteractionAvailabilityChanged();
+		}
+	}
+}
+
+void UInteractionSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World && World->GetGameInstance() == GetGameInstance())
+	{
+		if (TickType != LEVELTICK_ViewportsOnly && false == World->IsPaused())
+		{
+			INTERACTION_SCOPE_CYCLE_COUNTER(AdvanceTimerWheel);
+			TimerWheel.Advance(DeltaSeconds);
+			SET_DWORD_STAT(STAT_InteractionTimers, TimerWheel.Num());
+		}
+
+		MergeLevelIndices();
+
+		// cameras are updated at this point, and async traces requested by focus updates go out this frame
+		ScheduleFocusUpdates(World);
+		SubmitFocusTraces(World);
+	}
+}
+
+void UInteractionSubsystem::RegisterFocusSource(const UObject* Source, float Range, FGetFocusView&& GetView, FSimpleDelegate&& UpdateFocus)
+{
+	check(Source);
+
+	UnregisterFocusSource(Source);
+
+	FFocusSource& FocusSource = FocusSources.AddDefaulted_GetRef();
+	FocusSource.Source = Source;
+	FocusSource.Range = Range;
+	FocusSource.GetView = MoveTemp(GetView);
+	FocusSource.UpdateFocus = MoveTemp(UpdateFocus);
+	FocusSource.LastLocation = FVector::ZeroVector;
+	FocusSource.LastRotation = FQuat::Identity;
+	FocusSource.LastUpdateTime = 0.f;
+	FocusSource.bNeverUpdated = true;
+}
+
+void UInteractionSubsystem::UnregisterFocusSource(const UObject* Source)
+{
+	FocusSources.RemoveAllSwap([Source](const FFocusSource& FocusSource) { return FocusSource.Source == Source; });
+}
+
+void UInteractionSubsystem::RegisterInteractive(UInteractiveBoxComponent* Interactive)
+{
+	check(Interactive);
+
+	if (EntryIndices.Contains(Interactive))
+	{
+		UpdateInteractive(Interactive);
+		return;
+	}
+
+	const FBox Bounds = Interactive->Bounds.GetBox();
+	const FIntVector Cell = GetEntryCell(Bounds);
+
+	const int32 Index = EntryComponents.Add(Interactive);
+	EntryPriorities.Add(Interactive->GetFocusPriority());
+	EntryBounds.Add(Bounds);
+	EntryCells.Add(Cell);
+	EntryIndices.Add(Interactive, Index);
+	AddToCell(Index, Cell);
+
+	// e.g. spawned under the crosshair
+	MarkFocusDirty(Bounds);
+}
+
+void UInteractionSubsystem::UnregisterInteractive(UInteractiveBoxComponent* Interactive)
+{
+	int32 Index;
+	if (false == EntryIndices.RemoveAndCopyValue(Interactive, Index))
+	{
+		return;
+	}
+
+	RemoveFromCell(Index, EntryCells[Index]);
+	MarkFocusDirty(EntryBounds[Index]);
+
+	// the last entry takes the removed slot
+	const int32 LastIndex = EntryComponents.Num() - 1;
+	if (Index != LastIndex)
+	{
+		RemoveFromCell(LastIndex, EntryCells[LastIndex]);
+		AddToCell(Index, EntryCells[LastIndex]);
+		EntryIndices[EntryComponents[LastIndex]] = Index;
+	}
+
+	EntryComponents.RemoveAtSwap(Index, 1, false);
+	EntryPriorities.RemoveAtSwap(Index, 1, false);
+	EntryBounds.RemoveAtSwap(Index, 1, false);
+	EntryCells.RemoveAtSwap(Index, 1, false);
+}
+
+void UInteractionSubsystem::UpdateInteractive(UInteractiveBoxComponent* Interactive)
+{
+	const int32* Index = EntryIndices.Find(Interactive);
+	if (Index == nullptr)
+	{
+		return;
+	}
+
+	const FBox Bounds = Interactive->Bounds.GetBox();
+	const FIntVector Cell = GetEntryCell(Bounds);
+
+	// leaving the range of a focus source matters as much as entering it
+	MarkFocusDirty(EntryBounds[*Index]);
+	MarkFocusDirty(Bounds);
+
+	EntryBounds[*Index] = Bounds;
+	EntryPriorities[*Index] = Interactive->GetFocusPriority();
+	if (Cell != EntryCells[*Index])
+	{
+		RemoveFromCell(*Index, EntryCells[*Index]);
+		AddToCell(*Index, Cell);
+		EntryCells[*Index] = Cell;
+	}
+}
+
+void UInteractionSubsystem::MarkFocusDirty(const FBox& Bounds)
+{
+	// e.g. dedicated server
+	if (FocusSources.Num() > 0)
+	{
+		ChangedInteractiveBounds.Add(Bounds);
+	}
+}
+
+void UInteractionSubsystem::AddLevelIndex(AInteractiveLevelIndex* LevelIndex)
+{
+	check(LevelIndex);
+
+	RemoveLevelIndex(LevelIndex, false);
+
+	FPendingLevelIndex& Pending = PendingLevelIndices.AddDefaulted_GetRef();
+	Pending.LevelIndex = LevelIndex;
+	Pending.NextEntry = 0;
+}
+
+void UInteractionSubsystem::RemoveLevelIndex(AInteractiveLevelIndex* LevelIndex, bool bAddRemainingEntries)
+{
+	const int32 PendingIndex = PendingLevelIndices.IndexOfByPredicate([LevelIndex](const FPendingLevelIndex& Pending) { return Pending.LevelIndex == LevelIndex; });
+	if (PendingIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	// entries added so far unregister themselves along with the level
+	const int32 NextEntry = PendingLevelIndices[PendingIndex].NextEntry;
+	PendingLevelIndices.RemoveAt(PendingIndex, 1, false);
+
+	if (bAddRemainingEntries && LevelIndex)
+	{
+		AddLevelIndexEntries(*LevelIndex, NextEntry, LevelIndex->GetInteractives().Num());
+	}
+}
+
+void UInteractionSubsystem::MergeLevelIndices()
+{
+	if (PendingLevelIndices.Num() == 0)
+	{
+		return;
+	}
+
+	INTERACTION_SCOPE_CYCLE_COUNTER(MergeLevelIndices);
+
+	int32 Budget = FMath::Max(LevelIndexEntriesPerFrame, 1);
+	while (Budget > 0 && PendingLevelIndices.Num() > 0)
+	{
+		FPendingLevelIndex& Pending = PendingLevelIndices[0];
+		const AInteractiveLevelIndex* LevelIndex = Pending.LevelIndex.Get();
+		if (LevelIndex == nullptr)
+		{
+			PendingLevelIndices.RemoveAt(0, 1, false);
+			continue;
+		}
+
+		const TArray<UInteractiveBoxComponent*>& Interactives = LevelIndex->GetInteractives();
+		const int32 LastEntry = FMath::Min(Pending.NextEntry + Budget, Interactives.Num());
+		AddLevelIndexEntries(*LevelIndex, Pending.NextEntry, LastEntry);
+		Budget -= LastEntry - Pending.NextEntry;
+		Pending.NextEntry = LastEntry;
+
+		if (Pending.NextEntry >= Interactives.Num())
+		{
+			PendingLevelIndices.RemoveAt(0, 1, false);
+		}
+	}
+}
+
+void UInteractionSubsystem::AddLevelIndexEntries(const AInteractiveLevelIndex& LevelIndex, int32 FirstEntry, int32 LastEntry)
+{
+	const TArray<UInteractiveBoxComponent*>& Interactives = LevelIndex.GetInteractives();
+	for (int32 Entry = FirstEntry; Entry < LastEntry; ++Entry)
+	{
+		UInteractiveBoxComponent* Interactive = Interactives[Entry];
+		// e.g. destroyed since the level was loaded
+		if (Interactive && false == Interactive->IsPendingKill() && Interactive->IsRegistered())
+		{
+			RegisterInteractive(Interactive);
+			Interactive->OnAddedByLevelIndex();
+		}
+	}
+}
+
+FIntVector UInteractionSubsystem::GetCell(const FVector& Location) const
+{
+	const float InvCellSize = 1.f / FMath::Max(RegistryCellSize, 1.f);
+	return FIntVector(FMath::FloorToInt(Location.X * InvCellSize), FMath::FloorToInt(Location.Y * InvCellSize), FMath::FloorToInt(Location.Z * InvCellSize));
+}
+
+const FIntVector UInteractionSubsystem::OversizedCell(MAX_int32, MAX_int32, MAX_int32);
+
+FIntVector UInteractionSubsystem::GetEntryCell(const FBox& Bounds) const
+{
+	// bucketing a large entry would expand every query by its extent
+	return Bounds.GetExtent().GetMax() > GetMaxCellEntryExtent() ? OversizedCell : GetCell(Bounds.GetCenter());
+}
+
+void UInteractionSubsystem::AddToCell(int32 Index, const FIntVector& Cell)
+{
+	if (Cell == OversizedCell)
+	{
+		OversizedEntries.Add(Index);
+		return;
+	}
+
+	Cells.FindOrAdd(Cell).Add(Index);
+}
+
+void UInteractionSubsystem::RemoveFromCell(int32 Index, const FIntVector& Cell)
+{
+	if (Cell == OversizedCell)
+	{
+		OversizedEntries.RemoveSingleSwap(Index, false);
+		return;
+	}
+
+	TArray<int32, TInlineAllocator<4>>* CellEntries = Cells.Find(Cell);
+	if (CellEntries)
+	{
+		CellEntries->RemoveSingleSwap(Index, false);
+		if (CellEntries->Num() == 0)
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+template<typename VisitorType>
+void UInteractionSubsystem::ForEachEntryInBox(const FBox& Box, VisitorType&& Visitor) const
+{
+	const FVector MaxEntryExtent(GetMaxCellEntryExtent());
+	const FIntVector MinCell = GetCell(Box.Min - MaxEntryExtent);
+	const FIntVector MaxCell = GetCell(Box.Max + MaxEntryExtent);
+
+	const int64 NumCells = int64(MaxCell.X - MinCell.X + 1) * int64(MaxCell.Y - MinCell.Y + 1) * int64(MaxCell.Z - MinCell.Z + 1);
+	if (NumCells > Cells.Num())
+	{
+		// more cells to visit than there are non empty ones, walking all entries is cheaper
+		for (int32 Index = 0; Index < EntryBounds.Num(); ++Index)
+		{
+			Visitor(Index);
+		}
+		return;
+	}
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				const TArray<int32, TInlineAllocator<4>>* CellEntries = Cells.Find(FIntVector(X, Y, Z));
+				if (CellEntries)
+				{
+					for (const int32 Index : *CellEntries)
+					{
+						Visitor(Index);
+					}
+				}
+			}
+		}
+	}
+
+	for (const int32 Index : OversizedEntries)
+	{
+		Visitor(Index);
+	}
+}
+
+void UInteractionSubsystem::QueryInteractivesInRadius(const FVector& Center, float Radius, TArray<UInteractiveBoxComponent*>& OutInteractives) const
+{
+	INTERACTION_SCOPE_CYCLE_COUNTER(QueryInteractives);
+
+	const float RadiusSquared = FMath::Square(Radius);
+	ForEachEntryInBox(FBox::BuildAABB(Center, FVector(Radius)), [&](int32 Index)
+	{
+		if (EntryBounds[Index].ComputeSquaredDistanceToPoint(Center) <= RadiusSquared)
+		{
+			OutInteractives.Add(EntryComponents[Index]);
+		}
+	});
+}
+
+void UInteractionSubsystem::QueryInteractivesInBox(const FBox& Box, TArray<UInteractiveBoxComponent*>& OutInteractives) const
+{
+	INTERACTION_SCOPE_CYCLE_COUNTER(QueryInteractives);
+
+	ForEachEntryInBox(Box, [&](int32 Index)
+	{
+		if (EntryBounds[Index].Intersect(Box))
+		{
+			OutInteractives.Add(EntryComponents[Index]);
+		}
+	});
+}
+
+void UInteractionSubsystem::QueryInteractivesInFrustum(const FConvexVolume& Frustum, const FBox& FrustumBounds, TArray<UInteractiveBoxComponent*>& OutInteractives) const
+{
+	INTERACTION_SCOPE_CYCLE_COUNTER(QueryInteractives);
+
+	auto TestEntry = [&](int32 Index)
+	{
+		FVector Origin, Extent;
+		EntryBounds[Index].GetCenterAndExtents(Origin, Extent);
+		if (Frustum.IntersectBox(Origin, Extent))
+		{
+			OutInteractives.Add(EntryComponents[Index]);
+		}
+	};
+
+	if (FrustumBounds.IsValid)
+	{
+		ForEachEntryInBox(FrustumBounds, TestEntry);
+	}
+	else
+	{
+		for (int32 Index = 0; Index < EntryBounds.Num(); ++Index)
+		{
+			TestEntry(Index);
+		}
+	}
+}
+
+void UInteractionSubsystem::FindInteractivesForAgents(const TArray<FInteractionAgentQuery>& Queries, TArray<UInteractiveBoxComponent*>& OutInteractives) const
+{
+	INTERACTION_SCOPE_CYCLE_COUNTER(FindInteractivesForAgents);
+	check(IsInGameThread());
+
+	// a few ranked candidates per agent, so that disabled ones can be skipped on the game thread
+	static const int32 MaxCandidatesPerAgent = 4;
+	// agents per task, amortizes the task overhead and the candidates buffer
+	static const int32 AgentsPerTask = 16;
+
+	TArray<UInteractiveBoxComponent*> Candidates;
+	Candidates.SetNumZeroed(Queries.Num() * MaxCandidatesPerAgent);
+	// a byte per agent rather than a bit, agents of different tasks would share words
+	TArray<uint8> HasMoreCandidates;
+	HasMoreCandidates.SetNumZeroed(Queries.Num());
+
+	// workers only read the registry arrays, and write their own candidate slots
+	const int32 NumTasks = FMath::DivideAndRoundUp(Queries.Num(), AgentsPerTask);
+	ParallelFor(NumTasks, [this, &Queries, &Candidates, &HasMoreCandidates](int32 TaskIndex)
+	{
+		FInteractionFocusCandidates AgentCandidates;
+
+		const int32 LastQuery = FMath::Min((TaskIndex + 1) * AgentsPerTask, Queries.Num());
+		for (int32 QueryIndex = TaskIndex * AgentsPerTask; QueryIndex < LastQuery; ++QueryIndex)
+		{
+			GatherAgentCandidates(Queries[QueryIndex], AgentCandidates);
+
+			for (int32 Rank = 0; Rank < MaxCandidatesPerAgent; ++Rank)
+			{
+				const int32 Best = AgentCandidates.FindBest();
+				if (Best == INDEX_NONE)
+				{
+					break;
+				}
+				Candidates[QueryIndex * MaxCandidatesPerAgent + Rank] = static_cast<UInteractiveBoxComponent*>(AgentCandidates.GetInteractive(Best));
+				AgentCandidates.Discard(Best);
+			}
+			HasMoreCandidates[QueryIndex] = AgentCandidates.FindBest() != INDEX_NONE;
+		}
+	});
+
+	// back on the game thread, blueprint implementations included
+	OutInteractives.Reset(Queries.Num());
+	for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+	{
+		UInteractiveBoxComponent* Found = nullptr;
+		for (int32 Rank = 0; Rank < MaxCandidatesPerAgent && Found == nullptr; ++Rank)
+		{
+			UInteractiveBoxComponent* Candidate = Candidates[QueryIndex * MaxCandidatesPerAgent + Rank];
+			if (Candidate == nullptr)
+			{
+				break;
+			}
+			if (false == INTERACTIVE_EXECUTE(IInteractive, IsInteractionDisabled, Candidate))
+			{
+				Found = Candidate;
+			}
+		}
+
+		if (Found == nullptr && HasMoreCandidates[QueryIndex])
+		{
+			// all ranked candidates are disabled, rank the others here, it's the same ranking so the first ones are skipped without a dispatch
+			FInteractionFocusCandidates AgentCandidates;
+			GatherAgentCandidates(Queries[QueryIndex], AgentCandidates);
+
+			int32 Rank = 0;
+			int32 Best;
+			while (Found == nullptr && (Best = AgentCandidates.FindBest()) != INDEX_NONE)
+			{
+				UInteractiveBoxComponent* Candidate = static_cast<UInteractiveBoxComponent*>(AgentCandidates.GetInteractive(Best));
+				if (Rank++ >= MaxCandidatesPerAgent && false == INTERACTIVE_EXECUTE(IInteractive, IsInteractionDisabled, Candidate))
+				{
+					Found = Candidate;
+				}
+				AgentCandidates.Discard(Best);
+			}
+		}
+
+		OutInteractives.Add(Found);
+	}
+}
+
+void UInteractionSubsystem::GatherAgentCandidates(const FInteractionAgentQuery& Query, FInteractionFocusCandidates& OutCandidates) const
+{
+	OutCandidates.Reset();
+
+	const float ReachSquared = FMath::Square(Query.Reach);
+	ForEachEntryInBox(FBox::BuildAABB(Query.Location, FVector(Query.Reach)), [&](int32 Index)
+	{
+		if (EntryBounds[Index].ComputeSquaredDistanceToPoint(Query.Location) <= ReachSquared)
+		{
+			OutCandidates.Add(EntryComponents[Index], EntryBounds[Index].GetCenter(), EntryPriorities[Index]);
+		}
+	});
+
+	if (OutCandidates.Num() > 0)
+	{
+		// same scoring as the cone focus mode of players, distance breaks ties
+		OutCandidates.Score(Query.Location, Query.Direction, Query.Reach, Query.ConeHalfAngle, 0.25f);
+	}
+}
+
+void UInteractionSubsystem::InteractForAgents(const TArray<FInteractionAgentQuery>& Queries, TArray<UInteractiveBoxComponent*>& OutInteractives)
+{
+	FindInteractivesForAgents(Queries, OutInteractives);
+
+	for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+	{
+		APawn* Agent = Queries[QueryIndex].Agent;
+		if (OutInteractives[QueryIndex] && Agent && Agent->HasAuthority())
+		{
+			IInteractive::Interact(OutInteractives[QueryIndex], Agent);
+		}
+	}
+}
+
+void UInteractionSubsystem::ScheduleFocusUpdates(UWorld* World)
+{
+	INTERACTION_SCOPE_CYCLE_COUNTER(ScheduleFocusUpdates);
+
+	struct FCandidate
+	{
+		int32 Index;
+		float Priority;
+		FVector Location;
+		FQuat Rotation;
+	};
+	TArray<FCandidate, TInlineAllocator<8>> Candidates;
+
+	const float Now = World->GetTimeSeconds();
+	// compared with a quaternion dot, which is the cos of half the angle
+	const float CosHalfAngleThreshold = FMath::Cos(FMath::DegreesToRadians(FocusAngleThreshold) * 0.5f);
+
+	FocusSources.RemoveAllSwap([](const FFocusSource& FocusSource) { return false == FocusSource.Source.IsValid(); });
+
+	// copy delegates, a focus update may register or unregister sources
+	TArray<FSimpleDelegate, TInlineAllocator<8>> Updates;
+
+	for (int32 Index = 0; Index < FocusSources.Num(); ++Index)
+	{
+		FFocusSource& FocusSource = FocusSources[Index];
+
+		FVector Location;
+		FRotator Rotation;
+		if (false == FocusSource.GetView.IsBound() || false == FocusSource.GetView.Execute(Location, Rotation))
+		{
+			// view lost (e.g. unpossessed), one last update to drop focus, no trace involved so it's not budgeted
+			if (false == FocusSource.bNeverUpdated)
+			{
+				Updates.Add(FocusSource.UpdateFocus);
+			}
+			// it's updated as soon as it gets a view again
+			FocusSource.bNeverUpdated = true;
+			continue;
+		}
+		const FQuat Quat = Rotation.Quaternion();
+
+		// priority is how far beyond the thresholds the view changed, below 1 means no update needed
+		float Priority = 0.f;
+		if (FocusSource.bNeverUpdated)
+		{
+			Priority = BIG_NUMBER;
+		}
+		else
+		{
+			const float Distance = FVector::Dist(Location, FocusSource.LastLocation);
+			const float CosHalfAngle = FMath::Abs(Quat | FocusSource.LastRotation);
+			Priority = FMath::Max(Distance / FMath::Max(FocusLocationThreshold, KINDA_SMALL_NUMBER), (Now - FocusSource.LastUpdateTime) / FMath::Max(FocusMaxInterval, KINDA_SMALL_NUMBER));
+			if (CosHalfAngle < CosHalfAngleThreshold)
+			{
+				const float AngleDegrees = FMath::RadiansToDegrees(2.f * FMath::Acos(FMath::Min(CosHalfAngle, 1.f)));
+				Priority = FMath::Max(Priority, AngleDegrees / FMath::Max(FocusAngleThreshold, KINDA_SMALL_NUMBER));
+			}
+
+			if (Priority < 1.f)
+			{
+				const float RangeSquared = FMath::Square(FocusSource.Range);
+				for (const FBox& Bounds : ChangedInteractiveBounds)
+				{
+					if (Bounds.ComputeSquaredDistanceToPoint(Location) <= RangeSquared)
+					{
+						Priority = 1.f;
+						break;
+					}
+				}
+			}
+		}
+
+		if (Priority >= 1.f)
+		{
+			Candidates.Add({ Index, Priority, Location, Quat });
+		}
+	}
+
+	ChangedInteractiveBounds.Reset();
+
+	if (Candidates.Num() > MaxFocusUpdatesPerFrame)
+	{
+		// over budget, most changed first, the others keep accumulating changes (and so priority) until the next frame
+		Candidates.Sort([](const FCandidate& A, const FCandidate& B) { return A.Priority > B.Priority; });
+		INC_DWORD_STAT_BY(STAT_DeferredFocusUpdates, Candidates.Num() - MaxFocusUpdatesPerFrame);
+		Candidates.SetNum(FMath::Max(MaxFocusUpdatesPerFrame, 0), false);
+	}
+
+	INC_DWORD_STAT_BY(STAT_FocusUpdates, Candidates.Num());
+
+	for (const FCandidate& Candidate : Candidates)
+	{
+		FFocusSource& FocusSource = FocusSources[Candidate.Index];
+		FocusSource.LastLocation = Candidate.Location;
+		FocusSource.LastRotation = Candidate.Rotation;
+		FocusSource.LastUpdateTime = Now;
+		FocusSource.bNeverUpdated = false;
+		Updates.Add(FocusSource.UpdateFocus);
+	}
+
+	for (const FSimpleDelegate& UpdateFocus : Updates)
+	{
+		UpdateFocus.ExecuteIfBound();
+	}
+}
+
+void UInteractionSubsystem::SubmitFocusTraces(UWorld* World)
+{
+	if (PendingFocusTraces.Num() == 0)
+	{
+		return;
+	}
+
+	// the world buffers async traces of the frame and runs them in parallel tasks once the frame ends
+	int32 NumSubmitted = 0;
+	for (FFocusTraceRequest& Request : PendingFocusTraces)
+	{
+		if (Request.World == World && Request.Requester.IsValid())
+		{
+			const uint32 TraceId = NextFocusTraceId++;
+			World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Request.Start, Request.End, COLLISION_INTERACTIVE, Request.Params, FCollisionResponseParams::DefaultResponseParam, &FocusTraceDelegate, TraceId);
+			InFlightFocusTraces.Add(TraceId, MoveTemp(Request));
+			++NumSubmitted;
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_AsyncFocusTraces, NumSubmitted);
+	PendingFocusTraces.Reset();
+}
+
+void UInteractionSubsystem::OnFocusTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	FFocusTraceRequest Request;
+	if (false == InFlightFocusTraces.RemoveAndCopyValue(Datum.UserData, Request))
+	{
+		// cancelled
+		return;
+	}
+
+	if (Request.Requester.IsValid())
+	{
+		const FHitResult* Hit = Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit ? &Datum.OutHits[0] : nullptr;
+		Request.Callback.ExecuteIfBound(Hit);
+	}
+}
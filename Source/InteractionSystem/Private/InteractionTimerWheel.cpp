@@ -0,0 +1,206 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractionTimerWheel.h"
+
+FInteractionTimerWheel::FInteractionTimerWheel(float InTickInterval)
+{
+	Reset(InTickInterval);
+}
+
+void FInteractionTimerWheel::Reset(float InTickInterval)
+{
+	// bump serials so that outstanding handles get stale
+	for (FTimer& Timer : Timers)
+	{
+		++Timer.Serial;
+		Timer.Callback.Unbind();
+	}
+	FreeTimers.Reset();
+	for (int32 TimerIndex = Timers.Num() - 1; TimerIndex >= 0; --TimerIndex)
+	{
+		FreeTimers.Add(TimerIndex);
+	}
+
+	for (int32 Slot = 0; Slot < NumSlots; ++Slot)
+	{
+		SlotHeads[Slot] = INDEX_NONE;
+	}
+
+	TickInterval = FMath::Max(InTickInterval, KINDA_SMALL_NUMBER);
+	Accumulator = 0.f;
+	CurrentTick = 0;
+	NumPending = 0;
+}
+
+FInteractionTimerHandle FInteractionTimerWheel::Add(float Delay, FSimpleDelegate&& Callback)
+{
+	int32 TimerIndex;
+	if (FreeTimers.Num() > 0)
+	{
+		TimerIndex = FreeTimers.Pop(false);
+	}
+	else
+	{
+		TimerIndex = Timers.AddDefaulted();
+		Timers[TimerIndex].Serial = 0;
+	}
+
+	// at least one tick, a timer never fires from within Add
+	const uint64 DelayTicks = FMath::Clamp<uint64>((uint64)FMath::CeilToInt(FMath::Max(Delay, 0.f) / TickInterval), 1, MaxTicks);
+
+	FTimer& Timer = Timers[TimerIndex];
+	Timer.Callback = MoveTemp(Callback);
+	Timer.ExpireTick = CurrentTick + DelayTicks;
+	Link(TimerIndex);
+	++NumPending;
+
+	FInteractionTimerHandle Handle;
+	Handle.Index = TimerIndex;
+	Handle.Serial = Timer.Serial;
+	return Handle;
+}
+
+bool FInteractionTimerWheel::Remove(FInteractionTimerHandle& Handle)
+{
+	const bool bPending = IsPending(Handle);
+	if (bPending)
+	{
+		Unlink(Handle.Index);
+		FTimer& Timer = Timers[Handle.Index];
+		Timer.Callback.Unbind();
+		++Timer.Serial;
+		FreeTimers.Add(Handle.Index);
+		--NumPending;
+	}
+	Handle.Invalidate();
+	return bPending;
+}
+
+bool FInteractionTimerWheel::IsPending(const FInteractionTimerHandle& Handle) const
+{
+	return Timers.IsValidIndex(Handle.Index) && Timers[Handle.Index].Serial == Handle.Serial && Timers[Handle.Index].Slot != INDEX_NONE;
+}
+
+float FInteractionTimerWheel::GetRemaining(const FInteractionTimerHandle& Handle) const
+{
+	if (false == IsPending(Handle))
+	{
+		return 0.f;
+	}
+	return (Timers[Handle.Index].ExpireTick - CurrentTick) * TickInterval - Accumulator;
+}
+
+void FInteractionTimerWheel::Advance(float DeltaSeconds)
+{
+	Accumulator += DeltaSeconds;
+	while (Accumulator >= TickInterval)
+	{
+		Accumulator -= TickInterval;
+		Tick();
+	}
+}
+
+int32 FInteractionTimerWheel::GetSlot(uint64 ExpireTick) const
+{
+	const uint64 Delta = ExpireTick > CurrentTick ? ExpireTick - CurrentTick : 0;
+	if (Delta < Level0Slots)
+	{
+		return (int32)(ExpireTick & (Level0Slots - 1));
+	}
+
+	int32 Shift = Level0Bits;
+	for (int32 Level = 1; Level < NumLevels; ++Level, Shift += LevelBits)
+	{
+		if (Level == NumLevels - 1 || Delta < (1ull << (Shift + LevelBits)))
+		{
+			return Level0Slots + (Level - 1) * LevelSlots + (int32)((ExpireTick >> Shift) & (LevelSlots - 1));
+		}
+	}
+	check(false);
+	return INDEX_NONE;
+}
+
+void FInteractionTimerWheel::Link(int32 TimerIndex)
+{
+	FTimer& Timer = Timers[TimerIndex];
+	Timer.Slot = GetSlot(Timer.ExpireTick);
+	Timer.Prev = INDEX_NONE;
+	Timer.Next = SlotHeads[Timer.Slot];
+	if (Timer.Next != INDEX_NONE)
+	{
+		Timers[Timer.Next].Prev = TimerIndex;
+	}
+	SlotHeads[Timer.Slot] = TimerIndex;
+}
+
+void FInteractionTimerWheel::Unlink(int32 TimerIndex)
+{
+	FTimer& Timer = Timers[TimerIndex];
+	if (Timer.Prev != INDEX_NONE)
+	{
+		Timers[Timer.Prev].Next = Timer.Next;
+	}
+	else
+	{
+		SlotHeads[Timer.Slot] = Timer.Next;
+	}
+	if (Timer.Next != INDEX_NONE)
+	{
+		Timers[Timer.Next].Prev = Timer.Prev;
+	}
+	Timer.Slot = INDEX_NONE;
+	Timer.Prev = INDEX_NONE;
+	Timer.Next = INDEX_NONE;
+}
+
+void FInteractionTimerWheel::Cascade(int32 Slot)
+{
+	int32 TimerIndex = SlotHeads[Slot];
+	SlotHeads[Slot] = INDEX_NONE;
+	while (TimerIndex != INDEX_NONE)
+	{
+		const int32 Next = Timers[TimerIndex].Next;
+		Link(TimerIndex);
+		TimerIndex = Next;
+	}
+}
+
+void FInteractionTimerWheel::Tick()
+{
+	++CurrentTick;
+
+	// upper level slots are moved down when the level below completes a turn, before firing
+	uint64 Index = CurrentTick;
+	if ((Index & (Level0Slots - 1)) == 0)
+	{
+		Index >>= Level0Bits;
+		for (int32 Level = 1; Level < NumLevels; ++Level)
+		{
+			const int32 LevelIndex = (int32)(Index & (LevelSlots - 1));
+			Cascade(Level0Slots + (Level - 1) * LevelSlots + LevelIndex);
+			if (LevelIndex != 0)
+			{
+				break;
+			}
+			Index >>= LevelBits;
+		}
+	}
+
+	// callbacks may add or remove timers, so pop one at a time
+	const int32 Slot = (int32)(CurrentTick & (Level0Slots - 1));
+	while (SlotHeads[Slot] != INDEX_NONE)
+	{
+		const int32 TimerIndex = SlotHeads[Slot];
+		FTimer& Timer = Timers[TimerIndex];
+		Unlink(TimerIndex);
+
+		FSimpleDelegate Callback = MoveTemp(Timer.Callback);
+		Timer.Callback.Unbind();
+		++Timer.Serial;
+		FreeTimers.Add(TimerIndex);
+		--NumPending;
+
+		Callback.ExecuteIfBound();
+	}
+}
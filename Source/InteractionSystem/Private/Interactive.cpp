@@ -2,6 +2,7 @@
 
 
 #include "Interactive.h"
+#include "InteractiveDispatch.h"
 
 void IInteractive::Interact(UObject* Target, APawn* Interactor)
 {
@@ -14,11 +15,18 @@ void IInteractive::Interact(UObject* Target, APawn* Interactor)
 
 void IInteractive::StopInteraction(UObject* Target, APawn* Interactor)
 {
-	if (Target == nullptr || false == Target->GetClass()->ImplementsInterface(UInteractive::StaticClass()))
+	if (Target == nullptr)
 	{
 		// log error and return
 		return;
 	}
 
-	IInteractive::Execute_OnStopInteraction(Target, Interactor);
+	const FInteractiveClassInfo ClassInfo = FInteractiveClassInfo::Get(Target->GetClass());
+	if (false == ClassInfo.bImplementsInteractive)
+	{
+		// log error and return
+		return;
+	}
+
+	INTERACTIVE_EXECUTE_CACHED(ClassInfo, IInteractive, OnStopInteraction, Target, Interactor);
 }
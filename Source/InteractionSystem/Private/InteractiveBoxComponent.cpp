@@ -3,19 +3,38 @@
 
 #include "InteractiveBoxComponent.h"
 #include "GameFramework/Pawn.h"
+#include "GameFramework/GameStateBase.h"
 #include "InteractionSystem.h"
 #include "InteractiveActor.h"
+#include "InteractionSubsystem.h"
+#include "Components/TimelineComponent.h"
 #include "Net/UnrealNetwork.h"
+#include "TimerManager.h"
 
 #define LOCTEXT_NAMESPACE "InteractionSystem"
 
 UInteractiveBoxComponent::UInteractiveBoxComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
-
-	PrimaryComponentTick.bCanEverTick = true;
+	// no tick by default, see bTickWhileInteracting
+	PrimaryComponentTick.bCanEverTick = false;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	bTickWhileInteracting = false;
+	bPredictInteraction = false;
+	PredictionTimeout = 1.f;
+	FocusPriority = 0.f;
+	InteractionGroup = NAME_None;
+	InteractionGroupIndex = INDEX_NONE;
+	HoldDuration = 0.f;
+	HoldStartTime = -1.f;
+	bHolding = false;
+	bManageOwnerNetDormancy = false;
+	bRegisteredByLevelIndex = false;
+	bPendingLevelIndex = false;
+	NetDormancyQuietPeriod = 5.f;
+	bPollActorInteractionState = false;
 	
-	// actor (owner) must replicate too, and should always be relevant
+	// actor (owner) must replicate too, it is relevant within UInteractionReplicationGraph::InteractiveRelevancyRadius
 	bReplicates = true; // 4.22
 	// SetIsReplicatedByDefault(true); // 4.26
 
@@ -25,69 +44,348 @@ UInteractiveBoxComponent::UInteractiveBoxComponent(const FObjectInitializer& Obj
 	BoxExtent = FVector(16.0f, 16.0f, 16.0f);
 
 	bInteractionDisabled = false;
+
+	bOwnerInteractive = false;
+	bUseActorImplementation = false;
+	bPollInteractionState = false;
+	bActorInteractionDisabled = false;
+
+	bReplayingInteraction = false;
+	bPredictingInteraction = false;
+}
+
+void UInteractiveBoxComponent::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// not in the constructor: InitProperties copies the archetype events afterwards, binding to the archetype included
+	InteractionEvents.OnEventReceived.BindUObject(this, &UInteractiveBoxComponent::OnRep_InteractionEvent);
+}
+
+void UInteractiveBoxComponent::OnRegister()
+{
+	// must be set before the tick function gets registered, tick is then enabled on demand only
+	PrimaryComponentTick.bCanEverTick = bTickWhileInteracting;
+
+	Super::OnRegister();
+
+	INC_DWORD_STAT(STAT_RegisteredInteractives);
+
+	CacheInteractiveInfo();
+
+	InteractionSubsystem = UInteractionSubsystem::Get(this);
+
+	// on level load, the level index adds indexed components over a few frames, re-registrations after BeginPlay are immediate.
+	// Physics state is created right after OnRegister, and is deferred along with the registration.
+	bPendingLevelIndex = InteractionSubsystem.IsValid() && bRegisteredByLevelIndex && GetOwner() && false == GetOwner()->HasActorBegunPlay();
+	if (InteractionSubsystem.IsValid() && false == bPendingLevelIndex)
+	{
+		InteractionSubsystem->RegisterInteractive(this);
+	}
+}
+
+bool UInteractiveBoxComponent::ShouldCreatePhysicsState() const
+{
+	if (bPendingLevelIndex)
+	{
+		return false;
+	}
+	return Super::ShouldCreatePhysicsState();
+}
+
+void UInteractiveBoxComponent::OnAddedByLevelIndex()
+{
+	if (false == bPendingLevelIndex)
+	{
+		return;
+	}
+
+	bPendingLevelIndex = false;
+	if (IsRegistered() && false == IsPhysicsStateCreated())
+	{
+		RecreatePhysicsState();
+	}
+}
+
+void UInteractiveBoxComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// dormant until something happens, clients still get the initial state
+	AActor* Owner = GetOwner();
+	if (bManageOwnerNetDormancy && Owner && Owner->GetIsReplicated() && Owner->HasAuthority() && Owner->NetDormancy == DORM_Awake)
+	{
+		Owner->SetNetDormancy(DORM_DormantAll);
+	}
+
+	if (ShouldUseActorImplementation())
+	{
+		bActorInteractionDisabled = INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveActor, IsInteractionDisabled, Owner, this);
+	}
+}
+
+void UInteractiveBoxComponent::OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	Super::OnUpdateTransform(UpdateTransformFlags, Teleport);
+
+	// keep the registry up to date, and let players nearby refresh their focus
+	if (InteractionSubsystem.IsValid())
+	{
+		InteractionSubsystem->UpdateInteractive(this);
+	}
+}
+
+void UInteractiveBoxComponent::CacheInteractiveInfo()
+{
+	AActor* Owner = GetOwner();
+
+	ClassInfo = FInteractiveClassInfo::Get(GetClass());
+	OwnerClassInfo = Owner ? FInteractiveClassInfo::Get(Owner->GetClass()) : FInteractiveClassInfo();
+
+	bOwnerInteractive = OwnerClassInfo.bImplementsInteractiveActor;
+	// ShouldUseActorImplementation is not supposed to change at runtime, so it can be resolved once
+	bUseActorImplementation = bOwnerInteractive && INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveActor, ShouldUseActorImplementation, Owner);
+	// the actor implementation is refreshed after interaction events, blueprint implementations of this class are not refreshed at all
+	bPollInteractionState = (bUseActorImplementation && bPollActorInteractionState)
+		|| false == ClassInfo.CanCallNative(EInteractiveEvent::IInteractive_IsInteractionDisabled)
+		|| false == ClassInfo.CanCallNative(EInteractiveEvent::IInteractive_GetMessage);
+}
+
+void UInteractiveBoxComponent::OnUnregister()
+{
+	SetInteractionTickEnabled(false);
+
+	PendingPredictions.Reset();
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(TimerHandle_PredictionTimeout);
+		World->GetTimerManager().ClearTimer(TimerHandle_ExpireInteractionEvents);
+		World->GetTimerManager().ClearTimer(TimerHandle_FlushInteractionEvents);
+		World->GetTimerManager().ClearTimer(TimerHandle_RefreshActorInteractionState);
+	}
+
+	bPendingLevelIndex = false;
+
+	DEC_DWORD_STAT(STAT_RegisteredInteractives);
+
+	if (InteractionSubsystem.IsValid())
+	{
+		InteractionSubsystem->GetTimerWheel().Remove(HoldTimerHandle);
+		InteractionSubsystem->GetTimerWheel().Remove(NetDormancyTimerHandle);
+		InteractionSubsystem->UnregisterInteractive(this);
+	}
+	InteractionSubsystem.Reset();
+
+	Super::OnUnregister();
 }
 
 void UInteractiveBoxComponent::TryInteract(APawn* Interactor) 
 {
-	const bool bInteractionDisabled_ = IInteractive::Execute_IsInteractionDisabled(this);
+	INTERACTION_SCOPE_CYCLE_COUNTER(TryInteract);
+
+	const bool bInteractionDisabled_ = INTERACTIVE_EXECUTE_CACHED(ClassInfo, IInteractive, IsInteractionDisabled, this);
 	if (false == bInteractionDisabled_)
 	{
-		const bool bCanInteract = IInteractive::Execute_CanInteract(this, Interactor);
-		IInteractive::Execute_OnInteract(this, Interactor, bCanInteract);
+		const bool bCanInteract = INTERACTIVE_EXECUTE_CACHED(ClassInfo, IInteractive, CanInteract, this, Interactor);
+		INTERACTIVE_EXECUTE_CACHED(ClassInfo, IInteractive, OnInteract, this, Interactor, bCanInteract);
 	}
 }
 
 void UInteractiveBoxComponent::OnInteract_Implementation(APawn* Interactor, bool bCanInteract)
 {
-	const bool bFromReplication = LastInteraction.bFromRep;
+	INTERACTION_SCOPE_CYCLE_COUNTER(OnInteract);
+
+	const bool bFromReplication = bReplayingInteraction;
 	if (bFromReplication || (false == CurrentInteractor.IsValid() && Interactor && Interactor->HasAuthority()))
 	{
 		CurrentInteractor = Interactor;
 
+		if (false == bFromReplication)
+		{
+			InteractionStats::RecordInteraction(bCanInteract);
+
+			FInteractionData Event;
+			Event.Interactor = Interactor;
+			Event.bCanInteract = bCanInteract;
+			Event.bStopInteraction = false;
+			Event.bHasPredictionKey = FScopedInteractionPredictionKey::GetCurrent(Event.PredictionKey);
+			AddInteractionEvent(Event);
+		}
+
+		SetInteractionTickEnabled(bCanInteract);
+
+		// a denied event while holding can only be the rollback of a predicted success
+		if (bHolding)
+		{
+			EndHold(bFromReplication);
+		}
+		if (bCanInteract && HoldDuration > 0.f)
+		{
+			BeginHold(bFromReplication);
+		}
+
 		if (IsOwnerInteractive())
 		{
 			if (bCanInteract)
 			{
-				IInteractiveActor::Execute_OnInteractionSucceeded(GetOwner(), this, Interactor);
+				INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveActor, OnInteractionSucceeded, GetOwner(), this, Interactor);
 			}
 			else
 			{
-				IInteractiveActor::Execute_OnInteractionDenied(GetOwner(), this, Interactor);
+				INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveActor, OnInteractionDenied, GetOwner(), this, Interactor);
 			}
 		}
 
-		LastInteraction.bCanInteract = bCanInteract;
-		LastInteraction.Interactor = Interactor;
-		LastInteraction.bStopInteraction = false;
-		LastInteraction.EnsureReplication();
+		NotifyInteractionStateChanged();
+		ScheduleActorInteractionStateRefresh();
 	}
 
 }
 
 void UInteractiveBoxComponent::OnStopInteraction_Implementation(APawn* Interactor)
 {
-	const bool bFromReplication = LastInteraction.bFromRep;
+	INTERACTION_SCOPE_CYCLE_COUNTER(OnStopInteraction);
+
+	const bool bFromReplication = bReplayingInteraction;
 	if (bFromReplication || CurrentInteractor.IsValid() && CurrentInteractor == Interactor)
 	{
 		CurrentInteractor = nullptr;
 
+		if (false == bFromReplication)
+		{
+			FInteractionData Event;
+			Event.Interactor = Interactor;
+			Event.bStopInteraction = true;
+			Event.bHasPredictionKey = FScopedInteractionPredictionKey::GetCurrent(Event.PredictionKey);
+			AddInteractionEvent(Event);
+		}
+
+		SetInteractionTickEnabled(false);
+
+		const bool bHoldCanceled = bHolding;
+		if (bHoldCanceled)
+		{
+			EndHold(bFromReplication);
+		}
+
 		if (IsOwnerInteractive())
 		{
-			IInteractiveActor::Execute_OnStopInteraction(GetOwner(), this, Interactor);
+			if (bHoldCanceled)
+			{
+				INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveActor, OnInteractionHoldCanceled, GetOwner(), this, Interactor);
+			}
+			INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveActor, OnStopInteraction, GetOwner(), this, Interactor);
+		}
+
+		NotifyInteractionStateChanged();
+		ScheduleActorInteractionStateRefresh();
+	}
+
+}
+
+void UInteractiveBoxComponent::BeginHold(bool bFromReplication)
+{
+	bHolding = true;
+
+	// clients set it too, so that the progress starts right away for a predicted interaction, the replicated value then overrides it
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	HoldStartTime = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+
+	if (false == bFromReplication)
+	{
+		INTERACTION_MARK_PROPERTY_DIRTY(UInteractiveBoxComponent, HoldStartTime, this);
+
+		if (InteractionSubsystem.IsValid())
+		{
+			FInteractionTimerWheel& TimerWheel = InteractionSubsystem->GetTimerWheel();
+			TimerWheel.Remove(HoldTimerHandle);
+			HoldTimerHandle = TimerWheel.Add(HoldDuration, FSimpleDelegate::CreateUObject(this, &UInteractiveBoxComponent::OnHoldTimerExpired));
+		}
+		else
+		{
+			UE_LOG(LogInteraction, Warning, TEXT("%s: no interaction subsystem, the hold will never complete"), *GetPathName());
+		}
+	}
+}
+
+void UInteractiveBoxComponent::EndHold(bool bFromReplication)
+{
+	bHolding = false;
+	HoldStartTime = -1.f;
+
+	if (false == bFromReplication)
+	{
+		INTERACTION_MARK_PROPERTY_DIRTY(UInteractiveBoxComponent, HoldStartTime, this);
+
+		if (InteractionSubsystem.IsValid())
+		{
+			InteractionSubsystem->GetTimerWheel().Remove(HoldTimerHandle);
 		}
+		HoldTimerHandle.Invalidate();
+	}
+}
+
+void UInteractiveBoxComponent::OnHoldTimerExpired()
+{
+	HoldTimerHandle.Invalidate();
+
+	if (bHolding)
+	{
+		CompleteHold(CurrentInteractor.Get());
+	}
+}
 
-		LastInteraction.Interactor = Interactor;
-		LastInteraction.bStopInteraction = true;
-		LastInteraction.EnsureReplication();
+void UInteractiveBoxComponent::CompleteHold(APawn* Interactor)
+{
+	const bool bFromReplication = bReplayingInteraction;
+	if (false == bFromReplication)
+	{
+		FInteractionData Event;
+		Event.Interactor = Interactor;
+		Event.bCanInteract = true;
+		Event.bHoldCompleted = true;
+		AddInteractionEvent(Event);
 	}
+	else if (false == bHolding)
+	{
+		// e.g. joined in the middle of the hold, there's nothing to complete
+		return;
+	}
+
+	EndHold(bFromReplication);
 
+	if (IsOwnerInteractive())
+	{
+		INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveActor, OnInteractionHoldCompleted, GetOwner(), this, Interactor);
+	}
+
+	NotifyInteractionStateChanged();
+	ScheduleActorInteractionStateRefresh();
+}
+
+float UInteractiveBoxComponent::GetHoldProgress() const
+{
+	if (HoldStartTime < 0.f || HoldDuration <= 0.f)
+	{
+		return 0.f;
+	}
+
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	const float Now = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+	return FMath::Clamp((Now - HoldStartTime) / HoldDuration, 0.f, 1.f);
+}
+
+void UInteractiveBoxComponent::OnRep_HoldStartTime()
+{
+	// e.g. joined in the middle of the hold, so the HUD can show the progress
+	NotifyInteractionStateChanged();
 }
 
 void UInteractiveBoxComponent::OnFocusReceived_Implementation(APawn* Interactor)
 {
 	if (IsOwnerInteractive())
 	{
-		IInteractiveActor::Execute_OnFocusReceived(GetOwner(), this, Interactor);
+		INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveActor, OnFocusReceived, GetOwner(), this, Interactor);
 	}
 }
 
@@ -95,7 +393,7 @@ void UInteractiveBoxComponent::OnFocusLost_Implementation(APawn* Interactor)
 {
 	if (IsOwnerInteractive())
 	{
-		IInteractiveActor::Execute_OnFocusLost(GetOwner(), this, Interactor);
+		INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveActor, OnFocusLost, GetOwner(), this, Interactor);
 	}
 }
 
@@ -103,75 +401,451 @@ bool UInteractiveBoxComponent::CanInteract_Implementation(const APawn* Interacto
 {
 	if (ShouldUseActorImplementation()) 
 	{
-		return IInteractiveActor::Execute_CanInteract(GetOwner(), this, Interactor);
+		return INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveActor, CanInteract, GetOwner(), this, Interactor);
 	}
-	return false == IInteractive::Execute_IsInteractionDisabled(this);
+	return false == INTERACTIVE_EXECUTE_CACHED(ClassInfo, IInteractive, IsInteractionDisabled, this);
 }
 
 FText UInteractiveBoxComponent::GetMessage_Implementation(const APawn* Interactor) const 
 {
 	if (ShouldUseActorImplementation())
 	{
-		return IInteractiveActor::Execute_GetMessage(GetOwner(), this, Interactor);
+		return INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveActor, GetMessage, GetOwner(), this, Interactor);
 	}
 
-	const bool bInteractionDisabled_ = IInteractive::Execute_IsInteractionDisabled(this);
+	const bool bInteractionDisabled_ = INTERACTIVE_EXECUTE_CACHED(ClassInfo, IInteractive, IsInteractionDisabled, this);
 
 	return bInteractionDisabled_ ? LOCTEXT("InteractionDisabled", "INTERACTION DISABLED") : LOCTEXT("Interact", "INTERACT");
 }
 
 bool UInteractiveBoxComponent::IsInteractionDisabled_Implementation() const 
 {
+	if (IsInteractionGroupDisabled())
+	{
+		return true;
+	}
+
 	if (ShouldUseActorImplementation())
 	{
-		return IInteractiveActor::Execute_IsInteractionDisabled(GetOwner(), this);
+		return INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveActor, IsInteractionDisabled, GetOwner(), this);
 	}
 	
 	return bInteractionDisabled;
 }
 
-bool UInteractiveBoxComponent::ShouldUseActorImplementation() const
+int32 UInteractiveBoxComponent::GetInteractionGroupIndex() const
 {
-	if (IsOwnerInteractive())
+	// group indices never change once known, the table may just not be replicated yet
+	if (InteractionGroupIndex == INDEX_NONE && InteractionGroup != NAME_None && InteractionSubsystem.IsValid())
 	{
-		return IInteractiveActor::Execute_ShouldUseActorImplementation(GetOwner());
+		InteractionGroupIndex = InteractionSubsystem->FindInteractionGroup(InteractionGroup);
 	}
+	return InteractionGroupIndex;
+}
 
-	return false;
+bool UInteractiveBoxComponent::IsInteractionGroupDisabled() const
+{
+	if (InteractionGroup == NAME_None || false == InteractionSubsystem.IsValid())
+	{
+		return false;
+	}
+	return InteractionSubsystem->IsInteractionGroupDisabled(GetInteractionGroupIndex());
+}
+
+FOnInteractionAvailabilityChanged* UInteractiveBoxComponent::GetOnInteractionAvailabilityChanged()
+{
+	return &OnInteractionAvailabilityChanged;
+}
+
+FOnInteractionStateChanged* UInteractiveBoxComponent::GetOnInteractionStateChanged()
+{
+	return &OnInteractionStateChanged;
+}
+
+void UInteractiveBoxComponent::SetInteractionTickEnabled(bool bEnabled)
+{
+	if (false == PrimaryComponentTick.bCanEverTick || IsComponentTickEnabled() == bEnabled)
+	{
+		return;
+	}
+
+	SetComponentTickEnabled(bEnabled);
+
+	if (bEnabled)
+	{
+		INC_DWORD_STAT(STAT_TickingInteractives);
+	}
+	else
+	{
+		DEC_DWORD_STAT(STAT_TickingInteractives);
+	}
+}
+
+void UInteractiveBoxComponent::ForceOwnerNetUpdate()
+{
+	AActor* Owner = GetOwner();
+	if (Owner && Owner->GetIsReplicated() && Owner->HasAuthority())
+	{
+		if (bManageOwnerNetDormancy)
+		{
+			WakeOwnerNetDormancy();
+		}
+		Owner->ForceNetUpdate();
+	}
 }
 
-bool UInteractiveBoxComponent::IsOwnerInteractive() const 
+void UInteractiveBoxComponent::WakeOwnerNetDormancy()
 {
-	return GetOwner() && GetOwner()->GetClass()->ImplementsInterface(UInteractiveActor::StaticClass());
+	AActor* Owner = GetOwner();
+	if (Owner == nullptr || Owner->NetDormancy == DORM_Never)
+	{
+		return;
+	}
+
+	if (Owner->NetDormancy != DORM_Awake)
+	{
+		Owner->SetNetDormancy(DORM_Awake);
+	}
+
+	// restarting the quiet period on each change is O(1), and there's a single timer per component
+	if (InteractionSubsystem.IsValid())
+	{
+		FInteractionTimerWheel& TimerWheel = InteractionSubsystem->GetTimerWheel();
+		TimerWheel.Remove(NetDormancyTimerHandle);
+		NetDormancyTimerHandle = TimerWheel.Add(NetDormancyQuietPeriod, FSimpleDelegate::CreateUObject(this, &UInteractiveBoxComponent::OnNetDormancyQuietPeriodExpired));
+	}
+}
+
+void UInteractiveBoxComponent::OnNetDormancyQuietPeriodExpired()
+{
+	NetDormancyTimerHandle.Invalidate();
+
+	AActor* Owner = GetOwner();
+	if (Owner == nullptr || false == Owner->HasAuthority() || Owner->NetDormancy != DORM_Awake || false == InteractionSubsystem.IsValid())
+	{
+		return;
+	}
+
+	const FInteractionTimerWheel& TimerWheel = InteractionSubsystem->GetTimerWheel();
+	for (UActorComponent* Component : Owner->GetComponents())
+	{
+		const UInteractiveBoxComponent* Interactive = Cast<UInteractiveBoxComponent>(Component);
+		if (Interactive && Interactive != this && TimerWheel.IsPending(Interactive->NetDormancyTimerHandle))
+		{
+			// that one goes dormant when it's quiet too
+			return;
+		}
+	}
+
+	Owner->SetNetDormancy(DORM_DormantAll);
 }
 
 void UInteractiveBoxComponent::SetInteractionDisabled(bool bDisabled)
 {
-	bInteractionDisabled = bDisabled;
+	if (bInteractionDisabled != bDisabled)
+	{
+		bInteractionDisabled = bDisabled;
+		INTERACTION_MARK_PROPERTY_DIRTY(UInteractiveBoxComponent, bInteractionDisabled, this);
+		ForceOwnerNetUpdate();
+		NotifyInteractionAvailabilityChanged();
+	}
 }
 
-void UInteractiveBoxComponent::OnRep_LastInteraction() 
+void UInteractiveBoxComponent::NotifyInteractionAvailabilityChanged()
 {
+	// e.g. enabled under the crosshair of an idle player
+	if (InteractionSubsystem.IsValid())
+	{
+		InteractionSubsystem->MarkFocusDirty(Bounds.GetBox());
+	}
+
+	if (OnInteractionAvailabilityChanged.IsBound())
+	{
+		const bool bInteractionDisabled_ = INTERACTIVE_EXECUTE_CACHED(ClassInfo, IInteractive, IsInteractionDisabled, this);
+		OnInteractionAvailabilityChanged.Broadcast(this, bInteractionDisabled_);
+	}
+	NotifyInteractionStateChanged();
+}
+
+void UInteractiveBoxComponent::NotifyInteractionStateChanged()
+{
+	OnInteractionStateChanged.Broadcast(this);
+}
+
+void UInteractiveBoxComponent::ScheduleActorInteractionStateRefresh(float Delay)
+{
+	UWorld* World = GetWorld();
+	if (World && ShouldUseActorImplementation())
+	{
+		// events of the same frame share the refresh
+		FTimerManager& TimerManager = World->GetTimerManager();
+		if (false == TimerManager.IsTimerActive(TimerHandle_RefreshActorInteractionState) || Delay < TimerManager.GetTimerRemaining(TimerHandle_RefreshActorInteractionState))
+		{
+			TimerManager.SetTimer(TimerHandle_RefreshActorInteractionState, this, &UInteractiveBoxComponent::RefreshActorInteractionState, Delay, false);
+		}
+	}
+}
+
+void UInteractiveBoxComponent::RefreshActorInteractionState()
+{
+	// this timer is done, refreshes scheduled from now on (e.g. by an event the notifications cause) are new ones
+	TimerHandle_RefreshActorInteractionState.Invalidate();
+
+	AActor* Owner = GetOwner();
+	if (Owner == nullptr || false == ShouldUseActorImplementation())
+	{
+		return;
+	}
+
+	const bool bDisabled = INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveActor, IsInteractionDisabled, Owner, this);
+	if (bDisabled != bActorInteractionDisabled)
+	{
+		bActorInteractionDisabled = bDisabled;
+		NotifyInteractionAvailabilityChanged();
+	}
+	else
+	{
+		NotifyInteractionStateChanged();
+	}
+
+	// e.g. the door is disabled while its timeline plays, so evaluate again when it ends rather than polling meanwhile.
+	// Looping timelines never end, that's what bPollActorInteractionState is for.
+	float TimeLeft = MAX_flt;
+	TInlineComponentArray<UTimelineComponent*> Timelines(Owner);
+	for (const UTimelineComponent* Timeline : Timelines)
+	{
+		const float PlayRate = FMath::Abs(Timeline->GetPlayRate());
+		if (Timeline->IsPlaying() && false == Timeline->IsLooping() && PlayRate > KINDA_SMALL_NUMBER)
+		{
+			const float Position = Timeline->GetPlaybackPosition();
+			const float Remaining = Timeline->IsReversing() ? Position : Timeline->GetTimelineLength() - Position;
+			TimeLeft = FMath::Min(TimeLeft, FMath::Max(Remaining, 0.f) / PlayRate);
+		}
+	}
+	if (TimeLeft < MAX_flt)
+	{
+		// the timeline finishes on its tick, the refresh must come after it
+		ScheduleActorInteractionStateRefresh(TimeLeft + KINDA_SMALL_NUMBER);
+	}
+}
+
+void UInteractiveBoxComponent::OnRep_InteractionDisabled()
+{
+	NotifyInteractionAvailabilityChanged();
+}
+
+void UInteractiveBoxComponent::AddInteractionEvent(const FInteractionData& Event)
+{
+	InteractionEvents.AddEvent(Event, GetWorld()->GetTimeSeconds());
+	INTERACTION_MARK_PROPERTY_DIRTY(UInteractiveBoxComponent, InteractionEvents, this);
+	ForceOwnerNetUpdate();
+
+	FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+	if (false == TimerManager.IsTimerActive(TimerHandle_ExpireInteractionEvents))
+	{
+		TimerManager.SetTimer(TimerHandle_ExpireInteractionEvents, this, &UInteractiveBoxComponent::ExpireInteractionEvents, FInteractionEventArray::EventLifetime, false);
+	}
+}
+
+void UInteractiveBoxComponent::ExpireInteractionEvents()
+{
+	// otherwise expired events would stay until the next event, and be sent to players joining or getting in range meanwhile
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (InteractionEvents.RemoveExpiredEvents(Now))
+	{
+		INTERACTION_MARK_PROPERTY_DIRTY(UInteractiveBoxComponent, InteractionEvents, this);
+	}
+
+	float NextExpirationTime;
+	if (InteractionEvents.GetNextExpirationTime(NextExpirationTime))
+	{
+		GetWorld()->GetTimerManager().SetTimer(TimerHandle_ExpireInteractionEvents, this, &UInteractiveBoxComponent::ExpireInteractionEvents, FMath::Max(NextExpirationTime - Now, KINDA_SMALL_NUMBER), false);
+	}
+}
+
+void UInteractiveBoxComponent::OnRep_InteractionEvents()
+{
+	FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+	if (false == InteractionEvents.HasPendingEvents())
+	{
+		TimerManager.ClearTimer(TimerHandle_FlushInteractionEvents);
+	}
+	else if (false == TimerManager.IsTimerActive(TimerHandle_FlushInteractionEvents))
+	{
+		TimerManager.SetTimer(TimerHandle_FlushInteractionEvents, this, &UInteractiveBoxComponent::FlushInteractionEvents, FInteractionEventArray::MaxReorderDelay, false);
+	}
+}
+
+void UInteractiveBoxComponent::FlushInteractionEvents()
+{
+	InteractionEvents.FlushPendingEvents();
+}
+
+void UInteractiveBoxComponent::OnRep_InteractionEvent(const FInteractionData& Event) 
+{
+	INTERACTION_SCOPE_CYCLE_COUNTER(OnRep_InteractionEvent);
+
+	if (ReconcilePrediction(Event))
+	{
+		// already fired when predicted
+		return;
+	}
+
 	// we shouldn't call this fucntion on server (could check if owner is simulated proxy to be sure...)
-	LastInteraction.bFromRep = true;
-	if (LastInteraction.bStopInteraction) 
+	bReplayingInteraction = true;
+	if (Event.bStopInteraction) 
+	{
+		INTERACTIVE_EXECUTE_CACHED(ClassInfo, IInteractive, OnStopInteraction, this, Event.Interactor.Get());
+	}
+	else if (Event.bHoldCompleted)
 	{
-		IInteractive::Execute_OnStopInteraction(this, LastInteraction.Interactor.Get());
+		CompleteHold(Event.Interactor.Get());
 	}
 	else 
 	{
-		IInteractive::Execute_OnInteract(this, LastInteraction.Interactor.Get(), LastInteraction.bCanInteract);
+		INTERACTIVE_EXECUTE_CACHED(ClassInfo, IInteractive, OnInteract, this, Event.Interactor.Get(), Event.bCanInteract);
 	}
 	// reset flag
-	LastInteraction.bFromRep = false;
+	bReplayingInteraction = false;
+}
+
+void UInteractiveBoxComponent::PredictInteraction(APawn* Interactor, uint8 PredictionKey)
+{
+	if (false == bPredictInteraction || Interactor == nullptr || GetOwnerRole() == ROLE_Authority)
+	{
+		return;
+	}
+
+	// an active interaction would make server supersede or deny the command, don't predict on top of it
+	if (CurrentInteractor == Interactor || PendingPredictions.ContainsByPredicate([Interactor](const FInteractionPrediction& Prediction) { return Prediction.Interactor == Interactor; }))
+	{
+		return;
+	}
+
+	const bool bInteractionDisabled_ = INTERACTIVE_EXECUTE_CACHED(ClassInfo, IInteractive, IsInteractionDisabled, this);
+	if (bInteractionDisabled_)
+	{
+		return;
+	}
+
+	// replicated state only, e.g. bInteractionDisabled or whatever the actor implementation replicates
+	const bool bCanInteract = INTERACTIVE_EXECUTE_CACHED(ClassInfo, IInteractive, CanInteract, this, Interactor);
+
+	FInteractionPrediction& Prediction = PendingPredictions.AddDefaulted_GetRef();
+	Prediction.Interactor = Interactor;
+	Prediction.Time = GetWorld()->GetTimeSeconds();
+	Prediction.PredictionKey = PredictionKey;
+	Prediction.bCanInteract = bCanInteract;
+
+	FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+	if (false == TimerManager.IsTimerActive(TimerHandle_PredictionTimeout))
+	{
+		TimerManager.SetTimer(TimerHandle_PredictionTimeout, this, &UInteractiveBoxComponent::OnPredictionTimeout, PredictionTimeout, false);
+	}
+
+	PlayPredictedInteraction(Interactor, bCanInteract);
+}
+
+bool UInteractiveBoxComponent::IsPredictedInteraction() const
+{
+	return bPredictingInteraction;
+}
+
+void UInteractiveBoxComponent::PlayPredictedInteraction(APawn* Interactor, bool bCanInteract)
+{
+	// same path as a replicated event
+	bReplayingInteraction = true;
+	bPredictingInteraction = true;
+	INTERACTIVE_EXECUTE_CACHED(ClassInfo, IInteractive, OnInteract, this, Interactor, bCanInteract);
+	bPredictingInteraction = false;
+	bReplayingInteraction = false;
+}
+
+bool UInteractiveBoxComponent::ReconcilePrediction(const FInteractionData& Event)
+{
+	if (false == Event.bHasPredictionKey || PendingPredictions.Num() == 0)
+	{
+		return false;
+	}
+
+	const int32 Index = PendingPredictions.IndexOfByPredicate([&Event](const FInteractionPrediction& Prediction)
+	{
+		return Prediction.PredictionKey == Event.PredictionKey && Prediction.Interactor == Event.Interactor;
+	});
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const bool bPredictedCanInteract = PendingPredictions[Index].bCanInteract;
+	PendingPredictions.RemoveAt(Index, 1, false);
+
+	if (false == Event.bStopInteraction && Event.bCanInteract == bPredictedCanInteract)
+	{
+		INC_DWORD_STAT(STAT_ConfirmedPredictions);
+		return true;
+	}
+
+	// misprediction, replaying the server event rolls it back (e.g. a denied event after a predicted success)
+	INC_DWORD_STAT(STAT_RolledBackPredictions);
+	return false;
+}
+
+void UInteractiveBoxComponent::OnPredictionTimeout()
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	int32 NumExpired = 0;
+	while (NumExpired < PendingPredictions.Num() && Now - PendingPredictions[NumExpired].Time >= PredictionTimeout)
+	{
+		++NumExpired;
+	}
+
+	// copy, rollback events may predict again
+	TArray<FInteractionPrediction, TInlineAllocator<4>> Expired(PendingPredictions.GetData(), NumExpired);
+	PendingPredictions.RemoveAt(0, NumExpired, false);
+
+	for (const FInteractionPrediction& Prediction : Expired)
+	{
+		// server dropped the command, nothing to undo for a predicted denial
+		if (Prediction.bCanInteract)
+		{
+			UE_LOG(LogInteraction, Verbose, TEXT("%s: no server event for prediction %d, rolling back"), *GetPathName(), Prediction.PredictionKey);
+			INC_DWORD_STAT(STAT_RolledBackPredictions);
+			PlayPredictedInteraction(Prediction.Interactor.Get(), false);
+		}
+
+		// no stop event will come either (server has no interaction to stop), otherwise PredictInteraction would skip this interactor from now on
+		if (CurrentInteractor.IsValid() && CurrentInteractor == Prediction.Interactor)
+		{
+			CurrentInteractor = nullptr;
+			NotifyInteractionStateChanged();
+		}
+	}
+
+	if (PendingPredictions.Num() > 0)
+	{
+		const float Delay = FMath::Max(PendingPredictions[0].Time + PredictionTimeout - Now, KINDA_SMALL_NUMBER);
+		GetWorld()->GetTimerManager().SetTimer(TimerHandle_PredictionTimeout, this, &UInteractiveBoxComponent::OnPredictionTimeout, Delay, false);
+	}
 }
 
 void UInteractiveBoxComponent::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
+#if WITH_INTERACTION_PUSH_MODEL
+	// all properties change rarely, they are marked dirty explicitly (see INTERACTION_MARK_PROPERTY_DIRTY)
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UInteractiveBoxComponent, bInteractionDisabled, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UInteractiveBoxComponent, InteractionEvents, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UInteractiveBoxComponent, HoldStartTime, Params);
+#else
 	DOREPLIFETIME(UInteractiveBoxComponent, bInteractionDisabled);
-	DOREPLIFETIME(UInteractiveBoxComponent, LastInteraction);
+	DOREPLIFETIME(UInteractiveBoxComponent, InteractionEvents);
+	DOREPLIFETIME(UInteractiveBoxComponent, HoldStartTime);
+#endif
 	
 }
 
@@ -179,14 +853,243 @@ FInteractionData::FInteractionData()
 	: Interactor(NULL)
 	, bCanInteract(false)
 	, bStopInteraction(false)
-	, bFromRep(false)
-	, EnsureReplicationByte(0)
+	, bHoldCompleted(false)
+	, Sequence(0)
+	, bHasPredictionKey(false)
+	, PredictionKey(0)
+	, Instance(INDEX_NONE)
 {}
 
+namespace InteractionData
+{
+	enum EState : uint32
+	{
+		Succeeded,
+		Denied,
+		Stopped,
+		HoldCompleted,
+		NumStates
+	};
+}
+
+bool FInteractionData::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	// a null interactor is a single bit
+	uint8 bHasInteractor = Ar.IsSaving() && Map && Interactor.IsValid() ? 1 : 0;
+	Ar.SerializeBits(&bHasInteractor, 1);
+	if (bHasInteractor)
+	{
+		UObject* InteractorObject = Interactor.Get();
+		Map->SerializeObject(Ar, APawn::StaticClass(), InteractorObject);
+		if (Ar.IsLoading())
+		{
+			// unmapped interactor (e.g. not relevant to this client) is just null, events can handle that
+			Interactor = Cast<APawn>(InteractorObject);
+		}
+	}
+	else if (Ar.IsLoading())
+	{
+		Interactor = nullptr;
+	}
+
+	uint32 State = bStopInteraction ? InteractionData::Stopped : (bHoldCompleted ? InteractionData::HoldCompleted : (bCanInteract ? InteractionData::Succeeded : InteractionData::Denied));
+	Ar.SerializeInt(State, InteractionData::NumStates);
+	Ar.SerializeBits(&Sequence, 8);
+
+	uint8 bHasPredictionKey_ = bHasPredictionKey ? 1 : 0;
+	Ar.SerializeBits(&bHasPredictionKey_, 1);
+	if (bHasPredictionKey_)
+	{
+		Ar.SerializeBits(&PredictionKey, 8);
+	}
+
+	uint8 bHasInstance = Instance != INDEX_NONE ? 1 : 0;
+	Ar.SerializeBits(&bHasInstance, 1);
+	if (bHasInstance)
+	{
+		uint32 PackedInstance = (uint32)FMath::Max(Instance, 0);
+		Ar.SerializeIntPacked(PackedInstance);
+		if (Ar.IsLoading())
+		{
+			// checked against the instance count by the receiving component
+			Instance = (int32)FMath::Min<uint32>(PackedInstance, MAX_int32);
+		}
+	}
+	else if (Ar.IsLoading())
+	{
+		Instance = INDEX_NONE;
+	}
+
+	if (Ar.IsLoading())
+	{
+		bHasPredictionKey = bHasPredictionKey_;
+		bStopInteraction = State == InteractionData::Stopped;
+		bHoldCompleted = State == InteractionData::HoldCompleted;
+		bCanInteract = State == InteractionData::Succeeded || State == InteractionData::HoldCompleted;
+	}
+
+	return true;
+}
+
+bool FScopedInteractionPredictionKey::bCurrentValid = false;
+uint8 FScopedInteractionPredictionKey::CurrentKey = 0;
+
+FScopedInteractionPredictionKey::FScopedInteractionPredictionKey(uint8 InPredictionKey)
+	: bPreviousValid(bCurrentValid)
+	, PreviousKey(CurrentKey)
+{
+	check(IsInGameThread());
+	bCurrentValid = true;
+	CurrentKey = InPredictionKey;
+}
+
+FScopedInteractionPredictionKey::~FScopedInteractionPredictionKey()
+{
+	bCurrentValid = bPreviousValid;
+	CurrentKey = PreviousKey;
+}
+
+bool FScopedInteractionPredictionKey::GetCurrent(uint8& OutPredictionKey)
+{
+	OutPredictionKey = bCurrentValid ? CurrentKey : 0;
+	return bCurrentValid;
+}
+
+FInteractionEvent::FInteractionEvent()
+	: Time(0.f)
+{}
+
+void FInteractionEvent::PostReplicatedAdd(const FInteractionEventArray& InArraySerializer)
+{
+	// fast array callbacks get the array being received as const
+	const_cast<FInteractionEventArray&>(InArraySerializer).ReceiveEvent(Data);
+}
+
+FInteractionEventArray::FInteractionEventArray()
+	: NextSequence(0)
+	, LastReceivedSequence(0)
+	, bHasReceivedEvent(false)
+	, bReceivedInitialState(false)
+	, bReceivingInitialState(false)
+{}
+
+bool FInteractionEventArray::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+{
+	// the whole array is sent in the first state a client receives, events added before then are not replayed
+	const bool bInitialState = DeltaParms.Reader && false == bReceivedInitialState;
+	bReceivingInitialState = bInitialState;
+	const bool bResult = FFastArraySerializer::FastArrayDeltaSerialize<FInteractionEvent, FInteractionEventArray>(Events, DeltaParms, *this);
+	bReceivingInitialState = false;
+	bReceivedInitialState |= bInitialState;
+	return bResult;
+}
+
+void FInteractionEventArray::AddEvent(const FInteractionData& Data, float Time)
+{
+	RemoveExpiredEvents(Time);
+
+	// events are sorted by time, oldest first
+	const int32 NumOverflowing = Events.Num() - MaxEvents + 1;
+	if (NumOverflowing > 0)
+	{
+		Events.RemoveAt(0, NumOverflowing, false);
+		MarkArrayDirty();
+	}
+
+	FInteractionEvent& Event = Events.AddDefaulted_GetRef();
+	Event.Data = Data;
+	Event.Data.Sequence = NextSequence++;
+	Event.Time = Time;
+	MarkItemDirty(Event);
+}
+
+bool FInteractionEventArray::RemoveExpiredEvents(float Time)
+{
+	int32 NumExpired = 0;
+	while (NumExpired < Events.Num() && Time - Events[NumExpired].Time >= EventLifetime)
+	{
+		++NumExpired;
+	}
+	if (NumExpired == 0)
+	{
+		return false;
+	}
+
+	Events.RemoveAt(0, NumExpired, false);
+	MarkArrayDirty();
+	return true;
+}
+
+bool FInteractionEventArray::GetNextExpirationTime(float& OutTime) const
+{
+	OutTime = Events.Num() > 0 ? Events[0].Time + EventLifetime : 0.f;
+	return Events.Num() > 0;
+}
+
+void FInteractionEventArray::ReceiveEvent(const FInteractionData& Data)
+{
+	if (bReceivingInitialState)
+	{
+		// happened before this client got the component, but later events follow it
+		if (false == bHasReceivedEvent || Data.IsNewerThan(LastReceivedSequence))
+		{
+			LastReceivedSequence = Data.Sequence;
+			bHasReceivedEvent = true;
+		}
+		return;
+	}
+
+	if (bHasReceivedEvent && false == Data.IsNewerThan(LastReceivedSequence))
+	{
+		// already delivered, or given up on by FlushPendingEvents
+		return;
+	}
+
+	if (bHasReceivedEvent && Data.Sequence != (uint8)(LastReceivedSequence + 1))
+	{
+		// an older event is missing (e.g. it was lost and is being sent again), keep this one until it comes
+		const uint8 Distance = Data.Sequence - LastReceivedSequence;
+		int32 Index = 0;
+		while (Index < PendingEvents.Num() && (uint8)(PendingEvents[Index].Sequence - LastReceivedSequence) < Distance)
+		{
+			++Index;
+		}
+		if (false == PendingEvents.IsValidIndex(Index) || PendingEvents[Index].Sequence != Data.Sequence)
+		{
+			PendingEvents.Insert(Data, Index);
+		}
+		return;
+	}
+
+	DeliverEvent(Data);
+
+	// this may be the missing event others were waiting for
+	while (PendingEvents.Num() > 0 && PendingEvents[0].Sequence == (uint8)(LastReceivedSequence + 1))
+	{
+		const FInteractionData Next = PendingEvents[0];
+		PendingEvents.RemoveAt(0, 1, false);
+		DeliverEvent(Next);
+	}
+}
+
+void FInteractionEventArray::FlushPendingEvents()
+{
+	const TArray<FInteractionData> Flushed = MoveTemp(PendingEvents);
+	PendingEvents.Reset();
+
+	for (const FInteractionData& Data : Flushed)
+	{
+		DeliverEvent(Data);
+	}
+}
 
-void FInteractionData::EnsureReplication()
+void FInteractionEventArray::DeliverEvent(const FInteractionData& Data)
 {
-	EnsureReplicationByte++;
+	LastReceivedSequence = Data.Sequence;
+	bHasReceivedEvent = true;
+	OnEventReceived.ExecuteIfBound(Data);
 }
 
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
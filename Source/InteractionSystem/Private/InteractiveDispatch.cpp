@@ -0,0 +1,197 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractiveDispatch.h"
+#include "Interactive.h"
+#include "InteractiveActor.h"
+#include "InteractiveInstanced.h"
+#include "InteractiveInstancedActor.h"
+#include "UObject/Class.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+#if WITH_EDITOR
+#include "Editor.h"
+#endif
+
+namespace InteractiveDispatch
+{
+	static_assert((int32)EInteractiveEvent::Count <= 32, "BlueprintEventMask is too small");
+
+	const EInteractiveEvent FirstActorEvent = EInteractiveEvent::IInteractiveActor_OnInteractionSucceeded;
+	const EInteractiveEvent FirstInstancedActorEvent = EInteractiveEvent::IInteractiveInstancedActor_OnInstanceInteractionSucceeded;
+
+	bool IsNativeImplementation(const UClass* Class, const UClass* InterfaceClass)
+	{
+		for (const UClass* CurrentClass = Class; CurrentClass; CurrentClass = CurrentClass->GetSuperClass())
+		{
+			for (const FImplementedInterface& Interface : CurrentClass->Interfaces)
+			{
+				if (Interface.Class && Interface.Class->IsChildOf(InterfaceClass))
+				{
+					return false == Interface.bImplementedByK2;
+				}
+			}
+		}
+		return false;
+	}
+
+	bool IsOverriddenInBlueprint(const UClass* Class, FName EventName)
+	{
+		const UFunction* Function = Class->FindFunctionByName(EventName);
+		// nativized blueprints have native functions, but they still need ProcessEvent
+		return Function && (false == Function->HasAnyFunctionFlags(FUNC_Native) || Function->GetOwnerClass()->HasAnyClassFlags(CLASS_CompiledFromBlueprint));
+	}
+
+	// weak key, blueprint classes can be recompiled or garbage collected
+	TMap<TWeakObjectPtr<UClass>, FInteractiveClassInfo> ClassInfos;
+
+	void ResetClassInfos()
+	{
+		ClassInfos.Reset();
+	}
+
+	void RemoveStaleClassInfos()
+	{
+		for (auto It = ClassInfos.CreateIterator(); It; ++It)
+		{
+			if (false == It.Key().IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+#if WITH_EDITOR
+	void OnObjectsReplaced(const TMap<UObject*, UObject*>& OldToNewInstanceMap)
+	{
+		ResetClassInfos();
+	}
+
+	void OnBlueprintCompiled()
+	{
+		ResetClassInfos();
+	}
+#endif
+
+	/**
+	* register the cache invalidation once, on first use
+	*/
+	void InitClassInfos()
+	{
+		static bool bInitialized = false;
+		if (bInitialized)
+		{
+			return;
+		}
+		bInitialized = true;
+
+		FCoreUObjectDelegates::GetPostGarbageCollect().AddStatic(&RemoveStaleClassInfos);
+#if WITH_EDITOR
+		// a recompiled blueprint keeps its class, but its functions (and so the overridden events) are new
+		FCoreUObjectDelegates::OnObjectsReplaced.AddStatic(&OnObjectsReplaced);
+		if (GEditor)
+		{
+			GEditor->OnBlueprintCompiled().AddStatic(&OnBlueprintCompiled);
+		}
+#endif
+	}
+}
+
+FInteractiveClassInfo::FInteractiveClassInfo()
+	: bImplementsInteractive(false)
+	, bImplementsInteractiveActor(false)
+	, bImplementsInteractiveInstanced(false)
+	, bImplementsInteractiveInstancedActor(false)
+	, bNativeInteractive(false)
+	, bNativeInteractiveActor(false)
+	, bNativeInteractiveInstancedActor(false)
+	, BlueprintEventMask(0)
+{}
+
+bool FInteractiveClassInfo::CanCallNative(EInteractiveEvent Event) const
+{
+	const bool bNative = Event < InteractiveDispatch::FirstActorEvent ? bNativeInteractive
+		: (Event < InteractiveDispatch::FirstInstancedActorEvent ? bNativeInteractiveActor : bNativeInteractiveInstancedActor);
+	return bNative && 0 == (BlueprintEventMask & (1u << (uint32)Event));
+}
+
+FInteractiveClassInfo FInteractiveClassInfo::Get(const UClass* Class)
+{
+	check(IsInGameThread());
+
+	InteractiveDispatch::InitClassInfos();
+
+	const TWeakObjectPtr<UClass> Key(const_cast<UClass*>(Class));
+	if (const FInteractiveClassInfo* ClassInfo = InteractiveDispatch::ClassInfos.Find(Key))
+	{
+		return *ClassInfo;
+	}
+
+	FInteractiveClassInfo ClassInfo;
+	if (Class)
+	{
+		ClassInfo.Build(Class);
+	}
+	InteractiveDispatch::ClassInfos.Add(Key, ClassInfo);
+	return ClassInfo;
+}
+
+void FInteractiveClassInfo::Build(const UClass* Class)
+{
+	bImplementsInteractive = Class->ImplementsInterface(UInteractive::StaticClass());
+	bImplementsInteractiveActor = Class->ImplementsInterface(UInteractiveActor::StaticClass());
+	bImplementsInteractiveInstanced = Class->ImplementsInterface(UInteractiveInstanced::StaticClass());
+	bImplementsInteractiveInstancedActor = Class->ImplementsInterface(UInteractiveInstancedActor::StaticClass());
+	bNativeInteractive = bImplementsInteractive && InteractiveDispatch::IsNativeImplementation(Class, UInteractive::StaticClass());
+	bNativeInteractiveActor = bImplementsInteractiveActor && InteractiveDispatch::IsNativeImplementation(Class, UInteractiveActor::StaticClass());
+	bNativeInteractiveInstancedActor = bImplementsInteractiveInstancedActor && InteractiveDispatch::IsNativeImplementation(Class, UInteractiveInstancedActor::StaticClass());
+
+	BlueprintEventMask = 0;
+
+	auto CheckEvent = [this, Class](EInteractiveEvent Event, FName EventName)
+	{
+		if (InteractiveDispatch::IsOverriddenInBlueprint(Class, EventName))
+		{
+			BlueprintEventMask |= 1u << (uint32)Event;
+		}
+	};
+
+	if (bImplementsInteractive)
+	{
+		CheckEvent(EInteractiveEvent::IInteractive_OnInteract, GET_FUNCTION_NAME_CHECKED(IInteractive, OnInteract));
+		CheckEvent(EInteractiveEvent::IInteractive_OnStopInteraction, GET_FUNCTION_NAME_CHECKED(IInteractive, OnStopInteraction));
+		CheckEvent(EInteractiveEvent::IInteractive_OnFocusReceived, GET_FUNCTION_NAME_CHECKED(IInteractive, OnFocusReceived));
+		CheckEvent(EInteractiveEvent::IInteractive_OnFocusLost, GET_FUNCTION_NAME_CHECKED(IInteractive, OnFocusLost));
+		CheckEvent(EInteractiveEvent::IInteractive_CanInteract, GET_FUNCTION_NAME_CHECKED(IInteractive, CanInteract));
+		CheckEvent(EInteractiveEvent::IInteractive_GetMessage, GET_FUNCTION_NAME_CHECKED(IInteractive, GetMessage));
+		CheckEvent(EInteractiveEvent::IInteractive_IsInteractionDisabled, GET_FUNCTION_NAME_CHECKED(IInteractive, IsInteractionDisabled));
+	}
+
+	if (bImplementsInteractiveActor)
+	{
+		CheckEvent(EInteractiveEvent::IInteractiveActor_OnInteractionSucceeded, GET_FUNCTION_NAME_CHECKED(IInteractiveActor, OnInteractionSucceeded));
+		CheckEvent(EInteractiveEvent::IInteractiveActor_OnInteractionDenied, GET_FUNCTION_NAME_CHECKED(IInteractiveActor, OnInteractionDenied));
+		CheckEvent(EInteractiveEvent::IInteractiveActor_OnStopInteraction, GET_FUNCTION_NAME_CHECKED(IInteractiveActor, OnStopInteraction));
+		CheckEvent(EInteractiveEvent::IInteractiveActor_OnInteractionHoldCompleted, GET_FUNCTION_NAME_CHECKED(IInteractiveActor, OnInteractionHoldCompleted));
+		CheckEvent(EInteractiveEvent::IInteractiveActor_OnInteractionHoldCanceled, GET_FUNCTION_NAME_CHECKED(IInteractiveActor, OnInteractionHoldCanceled));
+		CheckEvent(EInteractiveEvent::IInteractiveActor_OnFocusReceived, GET_FUNCTION_NAME_CHECKED(IInteractiveActor, OnFocusReceived));
+		CheckEvent(EInteractiveEvent::IInteractiveActor_OnFocusLost, GET_FUNCTION_NAME_CHECKED(IInteractiveActor, OnFocusLost));
+		CheckEvent(EInteractiveEvent::IInteractiveActor_CanInteract, GET_FUNCTION_NAME_CHECKED(IInteractiveActor, CanInteract));
+		CheckEvent(EInteractiveEvent::IInteractiveActor_GetMessage, GET_FUNCTION_NAME_CHECKED(IInteractiveActor, GetMessage));
+		CheckEvent(EInteractiveEvent::IInteractiveActor_IsInteractionDisabled, GET_FUNCTION_NAME_CHECKED(IInteractiveActor, IsInteractionDisabled));
+		CheckEvent(EInteractiveEvent::IInteractiveActor_ShouldUseActorImplementation, GET_FUNCTION_NAME_CHECKED(IInteractiveActor, ShouldUseActorImplementation));
+	}
+
+	if (bImplementsInteractiveInstancedActor)
+	{
+		CheckEvent(EInteractiveEvent::IInteractiveInstancedActor_OnInstanceInteractionSucceeded, GET_FUNCTION_NAME_CHECKED(IInteractiveInstancedActor, OnInstanceInteractionSucceeded));
+		CheckEvent(EInteractiveEvent::IInteractiveInstancedActor_OnInstanceInteractionDenied, GET_FUNCTION_NAME_CHECKED(IInteractiveInstancedActor, OnInstanceInteractionDenied));
+		CheckEvent(EInteractiveEvent::IInteractiveInstancedActor_OnInstanceStopInteraction, GET_FUNCTION_NAME_CHECKED(IInteractiveInstancedActor, OnInstanceStopInteraction));
+		CheckEvent(EInteractiveEvent::IInteractiveInstancedActor_OnInstanceFocusReceived, GET_FUNCTION_NAME_CHECKED(IInteractiveInstancedActor, OnInstanceFocusReceived));
+		CheckEvent(EInteractiveEvent::IInteractiveInstancedActor_OnInstanceFocusLost, GET_FUNCTION_NAME_CHECKED(IInteractiveInstancedActor, OnInstanceFocusLost));
+		CheckEvent(EInteractiveEvent::IInteractiveInstancedActor_CanInteractInstance, GET_FUNCTION_NAME_CHECKED(IInteractiveInstancedActor, CanInteractInstance));
+		CheckEvent(EInteractiveEvent::IInteractiveInstancedActor_GetInstanceMessage, GET_FUNCTION_NAME_CHECKED(IInteractiveInstancedActor, GetInstanceMessage));
+		CheckEvent(EInteractiveEvent::IInteractiveInstancedActor_IsInstanceInteractionDisabled, GET_FUNCTION_NAME_CHECKED(IInteractiveInstancedActor, IsInstanceInteractionDisabled));
+		CheckEvent(EInteractiveEvent::IInteractiveInstancedActor_ShouldUseInstancedActorImplementation, GET_FUNCTION_NAME_CHECKED(IInteractiveInstancedActor, ShouldUseInstancedActorImplementation));
+	}
+}
@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractiveInstanced.h"
+
+void IInteractiveInstanced::Interact(UObject* Target, int32 Instance, APawn* Interactor)
+{
+	IInteractiveInstanced* Interactive = Cast<IInteractiveInstanced>(Target);
+	if (Interactive && Interactive->IsValidInstance(Instance))
+	{
+		Interactive->TryInteractInstance(Instance, Interactor);
+	}
+}
+
+void IInteractiveInstanced::StopInteraction(UObject* Target, int32 Instance, APawn* Interactor)
+{
+	IInteractiveInstanced* Interactive = Cast<IInteractiveInstanced>(Target);
+	if (Interactive && Interactive->IsValidInstance(Instance))
+	{
+		Interactive->StopInstanceInteraction(Instance, Interactor);
+	}
+}
@@ -0,0 +1,693 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractiveInstancedBoxComponent.h"
+#include "GameFramework/Pawn.h"
+#include "InteractionSystem.h"
+#include "InteractionSubsystem.h"
+#include "InteractiveInstancedActor.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "PrimitiveSceneProxy.h"
+#include "PrimitiveViewRelevance.h"
+#include "SceneManagement.h"
+#include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
+#include "TimerManager.h"
+
+#define LOCTEXT_NAMESPACE "InteractionSystem"
+
+/**
+* Wire boxes of the instances, in editor and with the collision show flag, like the box component.
+*/
+class FInteractiveInstancedBoxSceneProxy final : public FPrimitiveSceneProxy
+{
+public:
+
+	SIZE_T GetTypeHash() const override
+	{
+		static size_t UniquePointer;
+		return reinterpret_cast<size_t>(&UniquePointer);
+	}
+
+	FInteractiveInstancedBoxSceneProxy(const UInteractiveInstancedBoxComponent* InComponent)
+		: FPrimitiveSceneProxy(InComponent)
+		, BoxExtent(InComponent->BoxExtent)
+		, InstanceTransforms(InComponent->InstanceTransforms)
+		, Color(255, 0, 0)
+	{
+		bWillEverBeLit = false;
+	}
+
+	virtual void GetDynamicMeshElements(const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily, uint32 VisibilityMap, FMeshElementCollector& Collector) const override
+	{
+		const FMatrix& LocalToWorld = GetLocalToWorld();
+		const FLinearColor DrawColor = GetSelectionColor(Color, IsSelected(), IsHovered(), false);
+
+		for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ++ViewIndex)
+		{
+			if (VisibilityMap & (1 << ViewIndex))
+			{
+				FPrimitiveDrawInterface* PDI = Collector.GetPDI(ViewIndex);
+				for (const FTransform& InstanceTransform : InstanceTransforms)
+				{
+					const FMatrix InstanceToWorld = InstanceTransform.ToMatrixWithScale() * LocalToWorld;
+					DrawOrientedWireBox(PDI, InstanceToWorld.GetOrigin(), InstanceToWorld.GetScaledAxis(EAxis::X), InstanceToWorld.GetScaledAxis(EAxis::Y), InstanceToWorld.GetScaledAxis(EAxis::Z), BoxExtent, DrawColor, SDPG_World);
+				}
+			}
+		}
+	}
+
+	virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
+	{
+		FPrimitiveViewRelevance Result;
+		Result.bDrawRelevance = IsShown(View) || (View->Family->EngineShowFlags.Collision && IsCollisionEnabled());
+		Result.bDynamicRelevance = true;
+		Result.bShadowRelevance = false;
+		Result.bEditorPrimitiveRelevance = UseEditorCompositing(View);
+		return Result;
+	}
+
+	virtual uint32 GetMemoryFootprint() const override { return sizeof(*this) + GetAllocatedSize(); }
+
+	uint32 GetAllocatedSize() const { return FPrimitiveSceneProxy::GetAllocatedSize() + InstanceTransforms.GetAllocatedSize(); }
+
+private:
+
+	const FVector BoxExtent;
+	const TArray<FTransform> InstanceTransforms;
+	const FColor Color;
+};
+
+FInteractiveInstanceUse::FInteractiveInstanceUse()
+	: Instance(INDEX_NONE)
+	, Interactor(nullptr)
+{}
+
+void FInteractiveInstanceUseArray::SetInteractor(int32 Instance, APawn* Interactor)
+{
+	const int32 Index = Uses.IndexOfByPredicate([Instance](const FInteractiveInstanceUse& Other) { return Other.Instance == Instance; });
+	if (Interactor == nullptr)
+	{
+		if (Index != INDEX_NONE)
+		{
+			Uses.RemoveAtSwap(Index, 1, false);
+			MarkArrayDirty();
+		}
+		return;
+	}
+
+	FInteractiveInstanceUse& Use = Index != INDEX_NONE ? Uses[Index] : Uses.AddDefaulted_GetRef();
+	Use.Instance = Instance;
+	Use.Interactor = Interactor;
+	MarkItemDirty(Use);
+}
+
+APawn* FInteractiveInstanceUseArray::GetInteractor(int32 Instance) const
+{
+	const FInteractiveInstanceUse* Use = Uses.FindByPredicate([Instance](const FInteractiveInstanceUse& Other) { return Other.Instance == Instance; });
+	return Use ? Use->Interactor : nullptr;
+}
+
+void FInteractiveInstanceUseArray::Reset()
+{
+	Uses.Reset();
+	MarkArrayDirty();
+}
+
+UInteractiveInstancedBoxComponent::UInteractiveInstancedBoxComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	// actor (owner) must replicate too
+	bReplicates = true; // 4.22
+	// SetIsReplicatedByDefault(true); // 4.26
+
+	SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	SetCollisionResponseToAllChannels(ECR_Ignore);
+	SetCollisionResponseToChannel(COLLISION_INTERACTIVE, ECR_Block);
+	BoxExtent = FVector(16.0f, 16.0f, 16.0f);
+
+	// editor helper only, like the box component
+	bHiddenInGame = true;
+	bUseEditorCompositing = true;
+
+	InstanceBodySetup = nullptr;
+
+	bOwnerInteractive = false;
+	bUseActorImplementation = false;
+
+	bReplayingInteraction = false;
+}
+
+void UInteractiveInstancedBoxComponent::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// see UInteractiveBoxComponent::PostInitProperties
+	InteractionEvents.OnEventReceived.BindUObject(this, &UInteractiveInstancedBoxComponent::OnRep_InteractionEvent);
+}
+
+void UInteractiveInstancedBoxComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	INC_DWORD_STAT_BY(STAT_InteractiveInstances, InstanceTransforms.Num());
+
+	CacheInteractiveInfo();
+}
+
+void UInteractiveInstancedBoxComponent::OnUnregister()
+{
+	CurrentInteractors.Reset();
+	InstanceUses.Reset();
+
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(TimerHandle_ExpireInteractionEvents);
+		World->GetTimerManager().ClearTimer(TimerHandle_FlushInteractionEvents);
+	}
+
+	DEC_DWORD_STAT_BY(STAT_InteractiveInstances, InstanceTransforms.Num());
+
+	Super::OnUnregister();
+}
+
+void UInteractiveInstancedBoxComponent::CacheInteractiveInfo()
+{
+	AActor* Owner = GetOwner();
+
+	OwnerClassInfo = Owner ? FInteractiveClassInfo::Get(Owner->GetClass()) : FInteractiveClassInfo();
+
+	bOwnerInteractive = OwnerClassInfo.bImplementsInteractiveInstancedActor;
+	// ShouldUseInstancedActorImplementation is not supposed to change at runtime, so it can be resolved once
+	bUseActorImplementation = bOwnerInteractive && INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveInstancedActor, ShouldUseInstancedActorImplementation, Owner);
+}
+
+FBoxSphereBounds UInteractiveInstancedBoxComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	if (InstanceTransforms.Num() == 0)
+	{
+		return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.f);
+	}
+
+	const FBox InstanceBox(-BoxExtent, BoxExtent);
+	FBox Box(ForceInit);
+	for (const FTransform& InstanceTransform : InstanceTransforms)
+	{
+		Box += InstanceBox.TransformBy(InstanceTransform * LocalToWorld);
+	}
+	return FBoxSphereBounds(Box);
+}
+
+FPrimitiveSceneProxy* UInteractiveInstancedBoxComponent::CreateSceneProxy()
+{
+	return new FInteractiveInstancedBoxSceneProxy(this);
+}
+
+UBodySetup* UInteractiveInstancedBoxComponent::GetBodySetup()
+{
+	if (InstanceBodySetup == nullptr || InstanceBodySetup->IsPendingKill())
+	{
+		InstanceBodySetup = NewObject<UBodySetup>(this, NAME_None, RF_Transient);
+		InstanceBodySetup->CollisionTraceFlag = CTF_UseSimpleAsComplex;
+		InstanceBodySetup->bNeverNeedsCookedCollisionData = true;
+		InstanceBodySetup->AggGeom.BoxElems.Add(FKBoxElem());
+	}
+
+	// extent changes re-register the component, so the bodies are created again
+	FKBoxElem& Box = InstanceBodySetup->AggGeom.BoxElems[0];
+	Box.X = BoxExtent.X * 2.f;
+	Box.Y = BoxExtent.Y * 2.f;
+	Box.Z = BoxExtent.Z * 2.f;
+	return InstanceBodySetup;
+}
+
+void UInteractiveInstancedBoxComponent::OnCreatePhysicsState()
+{
+	// bodies of the instances instead of the component body, as in UInstancedStaticMeshComponent
+	USceneComponent::OnCreatePhysicsState();
+
+	CreateInstanceBodies(0);
+}
+
+void UInteractiveInstancedBoxComponent::OnDestroyPhysicsState()
+{
+	DestroyInstanceBodies();
+
+	USceneComponent::OnDestroyPhysicsState();
+}
+
+void UInteractiveInstancedBoxComponent::CreateInstanceBodies(int32 FirstInstance)
+{
+	FPhysScene* PhysScene = GetWorld() ? GetWorld()->GetPhysicsScene() : nullptr;
+	UBodySetup* BodySetup = GetBodySetup();
+	if (PhysScene == nullptr || BodySetup == nullptr)
+	{
+		return;
+	}
+
+	InstanceBodies.SetNumZeroed(InstanceTransforms.Num());
+
+	TArray<FBodyInstance*> NewBodies;
+	TArray<FTransform> NewTransforms;
+	NewBodies.Reserve(InstanceTransforms.Num() - FirstInstance);
+	NewTransforms.Reserve(InstanceTransforms.Num() - FirstInstance);
+
+	for (int32 Instance = FirstInstance; Instance < InstanceTransforms.Num(); ++Instance)
+	{
+		const FTransform InstanceToWorld = InstanceTransforms[Instance] * GetComponentTransform();
+		if (InstanceToWorld.GetScale3D().IsNearlyZero())
+		{
+			continue;
+		}
+
+		FBodyInstance* Body = new FBodyInstance();
+		Body->CopyBodyInstancePropertiesFrom(&BodyInstance);
+		// reported as the hit item, see UInteractionFocusComponent::GetInteractiveFromHit
+		Body->InstanceBodyIndex = Instance;
+		Body->bAutoWeld = false;
+		Body->SetInstanceSimulatePhysics(false);
+
+		InstanceBodies[Instance] = Body;
+		NewBodies.Add(Body);
+		NewTransforms.Add(InstanceToWorld);
+	}
+
+	if (NewBodies.Num() > 0)
+	{
+		FBodyInstance::InitStaticBodies(NewBodies, NewTransforms, BodySetup, this, PhysScene);
+	}
+}
+
+void UInteractiveInstancedBoxComponent::DestroyInstanceBodies()
+{
+	for (FBodyInstance* Body : InstanceBodies)
+	{
+		if (Body)
+		{
+			Body->TermBody();
+			delete Body;
+		}
+	}
+	InstanceBodies.Reset();
+}
+
+void UInteractiveInstancedBoxComponent::OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	// the component has no body of its own, instance bodies are moved below
+	Super::OnUpdateTransform(UpdateTransformFlags | EUpdateTransformFlags::SkipPhysicsUpdate, Teleport);
+
+	if (bPhysicsStateCreated && false == EnumHasAnyFlags(UpdateTransformFlags, EUpdateTransformFlags::SkipPhysicsUpdate))
+	{
+		for (int32 Instance = 0; Instance < InstanceBodies.Num(); ++Instance)
+		{
+			if (FBodyInstance* Body = InstanceBodies[Instance])
+			{
+				const FTransform InstanceToWorld = InstanceTransforms[Instance] * GetComponentTransform();
+				Body->SetBodyTransform(InstanceToWorld, Teleport);
+				Body->UpdateBodyScale(InstanceToWorld.GetScale3D());
+			}
+		}
+	}
+}
+
+int32 UInteractiveInstancedBoxComponent::AddInstance(const FTransform& InstanceTransform)
+{
+	const int32 Instance = InstanceTransforms.Add(InstanceTransform);
+
+	if (IsRegistered())
+	{
+		INC_DWORD_STAT(STAT_InteractiveInstances);
+
+		// only the new body, construction scripts add instances one at a time
+		if (bPhysicsStateCreated)
+		{
+			CreateInstanceBodies(Instance);
+		}
+		UpdateBounds();
+		MarkRenderStateDirty();
+	}
+	return Instance;
+}
+
+FTransform UInteractiveInstancedBoxComponent::GetInstanceTransform(int32 Instance, bool bWorldSpace) const
+{
+	if (false == IsValidInstance(Instance))
+	{
+		return FTransform::Identity;
+	}
+	return bWorldSpace ? InstanceTransforms[Instance] * GetComponentTransform() : InstanceTransforms[Instance];
+}
+
+void UInteractiveInstancedBoxComponent::TryInteractInstance(int32 Instance, APawn* Interactor)
+{
+	INTERACTION_SCOPE_CYCLE_COUNTER(TryInteract);
+
+	if (false == IsInstanceInteractionDisabled(Instance))
+	{
+		const bool bCanInteract = CanInteractInstance(Instance, Interactor);
+		InteractInstance(Instance, Interactor, bCanInteract);
+	}
+}
+
+void UInteractiveInstancedBoxComponent::InteractInstance(int32 Instance, APawn* Interactor, bool bCanInteract)
+{
+	INTERACTION_SCOPE_CYCLE_COUNTER(OnInteract);
+
+	const bool bFromReplication = bReplayingInteraction;
+	if (false == bFromReplication && (GetInstanceInteractor(Instance) || Interactor == nullptr || false == Interactor->HasAuthority()))
+	{
+		return;
+	}
+
+	CurrentInteractors.Add(Instance, Interactor);
+
+	if (false == bFromReplication)
+	{
+		InteractionStats::RecordInteraction(bCanInteract);
+
+		FInteractionData Event;
+		Event.Interactor = Interactor;
+		Event.bCanInteract = bCanInteract;
+		Event.bStopInteraction = false;
+		Event.Instance = Instance;
+		AddInteractionEvent(Event);
+
+		InstanceUses.SetInteractor(Instance, Interactor);
+		INTERACTION_MARK_PROPERTY_DIRTY(UInteractiveInstancedBoxComponent, InstanceUses, this);
+	}
+
+	if (bOwnerInteractive)
+	{
+		if (bCanInteract)
+		{
+			INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveInstancedActor, OnInstanceInteractionSucceeded, GetOwner(), this, Instance, Interactor);
+		}
+		else
+		{
+			INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveInstancedActor, OnInstanceInteractionDenied, GetOwner(), this, Instance, Interactor);
+		}
+	}
+
+	NotifyInstanceStateChanged(Instance);
+}
+
+void UInteractiveInstancedBoxComponent::StopInstanceInteraction(int32 Instance, APawn* Interactor)
+{
+	INTERACTION_SCOPE_CYCLE_COUNTER(OnStopInteraction);
+
+	const bool bFromReplication = bReplayingInteraction;
+	const APawn* CurrentInteractor = GetInstanceInteractor(Instance);
+	// a replayed stop is skipped if ReconcileInstanceUses stopped the interaction already
+	const bool bInUse = bFromReplication ? CurrentInteractors.Contains(Instance) : CurrentInteractor != nullptr;
+	if (false == bInUse || CurrentInteractor != Interactor)
+	{
+		return;
+	}
+
+	CurrentInteractors.Remove(Instance);
+
+	if (false == bFromReplication)
+	{
+		FInteractionData Event;
+		Event.Interactor = Interactor;
+		Event.bStopInteraction = true;
+		Event.Instance = Instance;
+		AddInteractionEvent(Event);
+
+		InstanceUses.SetInteractor(Instance, nullptr);
+		INTERACTION_MARK_PROPERTY_DIRTY(UInteractiveInstancedBoxComponent, InstanceUses, this);
+	}
+
+	if (bOwnerInteractive)
+	{
+		INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveInstancedActor, OnInstanceStopInteraction, GetOwner(), this, Instance, Interactor);
+	}
+
+	NotifyInstanceStateChanged(Instance);
+}
+
+APawn* UInteractiveInstancedBoxComponent::GetInstanceInteractor(int32 Instance) const
+{
+	const TWeakObjectPtr<APawn>* Interactor = CurrentInteractors.Find(Instance);
+	return Interactor ? Interactor->Get() : nullptr;
+}
+
+void UInteractiveInstancedBoxComponent::AddInteractionEvent(const FInteractionData& Event)
+{
+	InteractionEvents.AddEvent(Event, GetWorld()->GetTimeSeconds());
+	INTERACTION_MARK_PROPERTY_DIRTY(UInteractiveInstancedBoxComponent, InteractionEvents, this);
+	ForceOwnerNetUpdate();
+
+	FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+	if (false == TimerManager.IsTimerActive(TimerHandle_ExpireInteractionEvents))
+	{
+		TimerManager.SetTimer(TimerHandle_ExpireInteractionEvents, this, &UInteractiveInstancedBoxComponent::ExpireInteractionEvents, FInteractionEventArray::EventLifetime, false);
+	}
+}
+
+void UInteractiveInstancedBoxComponent::ExpireInteractionEvents()
+{
+	// see UInteractiveBoxComponent::ExpireInteractionEvents
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (InteractionEvents.RemoveExpiredEvents(Now))
+	{
+		INTERACTION_MARK_PROPERTY_DIRTY(UInteractiveInstancedBoxComponent, InteractionEvents, this);
+	}
+
+	float NextExpirationTime;
+	if (InteractionEvents.GetNextExpirationTime(NextExpirationTime))
+	{
+		GetWorld()->GetTimerManager().SetTimer(TimerHandle_ExpireInteractionEvents, this, &UInteractiveInstancedBoxComponent::ExpireInteractionEvents, FMath::Max(NextExpirationTime - Now, KINDA_SMALL_NUMBER), false);
+	}
+}
+
+void UInteractiveInstancedBoxComponent::ForceOwnerNetUpdate()
+{
+	AActor* Owner = GetOwner();
+	if (Owner && Owner->GetIsReplicated() && Owner->HasAuthority())
+	{
+		Owner->ForceNetUpdate();
+	}
+}
+
+void UInteractiveInstancedBoxComponent::OnInstanceFocusReceived(int32 Instance, APawn* Interactor)
+{
+	if (bOwnerInteractive)
+	{
+		INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveInstancedActor, OnInstanceFocusReceived, GetOwner(), this, Instance, Interactor);
+	}
+}
+
+void UInteractiveInstancedBoxComponent::OnInstanceFocusLost(int32 Instance, APawn* Interactor)
+{
+	if (bOwnerInteractive)
+	{
+		INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveInstancedActor, OnInstanceFocusLost, GetOwner(), this, Instance, Interactor);
+	}
+}
+
+bool UInteractiveInstancedBoxComponent::CanInteractInstance(int32 Instance, const APawn* Interactor) const
+{
+	if (bUseActorImplementation)
+	{
+		return INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveInstancedActor, CanInteractInstance, GetOwner(), this, Instance, Interactor);
+	}
+	return false == IsInstanceInteractionDisabled(Instance);
+}
+
+FText UInteractiveInstancedBoxComponent::GetInstanceMessage(int32 Instance, const APawn* Interactor) const
+{
+	if (bUseActorImplementation)
+	{
+		return INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveInstancedActor, GetInstanceMessage, GetOwner(), this, Instance, Interactor);
+	}
+
+	return IsInstanceInteractionDisabled(Instance) ? LOCTEXT("InteractionDisabled", "INTERACTION DISABLED") : LOCTEXT("Interact", "INTERACT");
+}
+
+bool UInteractiveInstancedBoxComponent::IsInstanceInteractionDisabled(int32 Instance) const
+{
+	if (bUseActorImplementation)
+	{
+		return INTERACTIVE_EXECUTE_CACHED(OwnerClassInfo, IInteractiveInstancedActor, IsInstanceInteractionDisabled, GetOwner(), this, Instance);
+	}
+
+	return IsInstanceDisabledBitSet(Instance);
+}
+
+FOnInstanceInteractionAvailabilityChanged* UInteractiveInstancedBoxComponent::GetOnInstanceInteractionAvailabilityChanged()
+{
+	return &OnInstanceInteractionAvailabilityChanged;
+}
+
+FOnInstanceInteractionStateChanged* UInteractiveInstancedBoxComponent::GetOnInstanceInteractionStateChanged()
+{
+	return &OnInstanceInteractionStateChanged;
+}
+
+void UInteractiveInstancedBoxComponent::SetInstanceInteractionDisabled(int32 Instance, bool bDisabled)
+{
+	if (false == IsValidInstance(Instance) || IsInstanceDisabledBitSet(Instance) == bDisabled)
+	{
+		return;
+	}
+
+	const int32 Word = Instance >> 5;
+	if (Word >= DisabledInstanceBits.Num())
+	{
+		DisabledInstanceBits.SetNumZeroed(Word + 1);
+	}
+	const uint32 Bit = 1u << (Instance & 31);
+	DisabledInstanceBits[Word] = bDisabled ? (DisabledInstanceBits[Word] | Bit) : (DisabledInstanceBits[Word] & ~Bit);
+
+	INTERACTION_MARK_PROPERTY_DIRTY(UInteractiveInstancedBoxComponent, DisabledInstanceBits, this);
+	ForceOwnerNetUpdate();
+	NotifyInstanceAvailabilityChanged(Instance);
+}
+
+void UInteractiveInstancedBoxComponent::OnRep_DisabledInstanceBits(const TArray<uint32>& OldDisabledInstanceBits)
+{
+	const int32 NumWords = FMath::Max(OldDisabledInstanceBits.Num(), DisabledInstanceBits.Num());
+	for (int32 Word = 0; Word < NumWords; ++Word)
+	{
+		const uint32 OldBits = OldDisabledInstanceBits.IsValidIndex(Word) ? OldDisabledInstanceBits[Word] : 0;
+		const uint32 NewBits = DisabledInstanceBits.IsValidIndex(Word) ? DisabledInstanceBits[Word] : 0;
+		for (uint32 ChangedBits = OldBits ^ NewBits; ChangedBits != 0; ChangedBits &= ChangedBits - 1)
+		{
+			const int32 Instance = (Word << 5) + (int32)FMath::CountTrailingZeros(ChangedBits);
+			if (IsValidInstance(Instance))
+			{
+				NotifyInstanceAvailabilityChanged(Instance);
+			}
+		}
+	}
+}
+
+void UInteractiveInstancedBoxComponent::NotifyInstanceAvailabilityChanged(int32 Instance)
+{
+	// see UInteractiveBoxComponent::NotifyInteractionAvailabilityChanged
+	UInteractionSubsystem* InteractionSubsystem = UInteractionSubsystem::Get(this);
+	if (InteractionSubsystem && IsValidInstance(Instance))
+	{
+		InteractionSubsystem->MarkFocusDirty(FBox(-BoxExtent, BoxExtent).TransformBy(GetInstanceTransform(Instance, true)));
+	}
+
+	if (OnInstanceInteractionAvailabilityChanged.IsBound())
+	{
+		OnInstanceInteractionAvailabilityChanged.Broadcast(this, Instance, IsInstanceInteractionDisabled(Instance));
+	}
+	NotifyInstanceStateChanged(Instance);
+}
+
+void UInteractiveInstancedBoxComponent::NotifyInstanceStateChanged(int32 Instance)
+{
+	OnInstanceInteractionStateChanged.Broadcast(this, Instance);
+}
+
+void UInteractiveInstancedBoxComponent::OnRep_InteractionEvent(const FInteractionData& Event)
+{
+	INTERACTION_SCOPE_CYCLE_COUNTER(OnRep_InteractionEvent);
+
+	if (false == IsValidInstance(Event.Instance))
+	{
+		UE_LOG(LogInteraction, Warning, TEXT("%s: event for unknown instance %d, instances must be the same on server and clients"), *GetPathName(), Event.Instance);
+		return;
+	}
+
+	bReplayingInteraction = true;
+	if (Event.bStopInteraction)
+	{
+		StopInstanceInteraction(Event.Instance, Event.Interactor.Get());
+	}
+	else
+	{
+		InteractInstance(Event.Instance, Event.Interactor.Get(), Event.bCanInteract);
+	}
+	bReplayingInteraction = false;
+}
+
+void UInteractiveInstancedBoxComponent::OnRep_InteractionEvents()
+{
+	FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+	if (false == InteractionEvents.HasPendingEvents())
+	{
+		TimerManager.ClearTimer(TimerHandle_FlushInteractionEvents);
+	}
+	else if (false == TimerManager.IsTimerActive(TimerHandle_FlushInteractionEvents))
+	{
+		TimerManager.SetTimer(TimerHandle_FlushInteractionEvents, this, &UInteractiveInstancedBoxComponent::FlushInteractionEvents, FInteractionEventArray::MaxReorderDelay, false);
+	}
+
+	ReconcileInstanceUses();
+}
+
+void UInteractiveInstancedBoxComponent::FlushInteractionEvents()
+{
+	InteractionEvents.FlushPendingEvents();
+	ReconcileInstanceUses();
+}
+
+void UInteractiveInstancedBoxComponent::OnRep_InstanceUses()
+{
+	ReconcileInstanceUses();
+}
+
+void UInteractiveInstancedBoxComponent::ReconcileInstanceUses()
+{
+	// called once the whole update was received, so InstanceUses is at least as recent as the replayed events
+	TArray<int32, TInlineAllocator<8>> StoppedInstances;
+	for (const TPair<int32, TWeakObjectPtr<APawn>>& CurrentInteractor : CurrentInteractors)
+	{
+		const APawn* Interactor = CurrentInteractor.Value.Get();
+		if (Interactor == nullptr || InstanceUses.GetInteractor(CurrentInteractor.Key) != Interactor)
+		{
+			StoppedInstances.Add(CurrentInteractor.Key);
+		}
+	}
+
+	for (const int32 Instance : StoppedInstances)
+	{
+		APawn* Interactor = GetInstanceInteractor(Instance);
+		if (Interactor == nullptr)
+		{
+			// interactor destroyed, nothing to tell
+			CurrentInteractors.Remove(Instance);
+			NotifyInstanceStateChanged(Instance);
+			continue;
+		}
+
+		bReplayingInteraction = true;
+		StopInstanceInteraction(Instance, Interactor);
+		bReplayingInteraction = false;
+	}
+
+	for (const FInteractiveInstanceUse& Use : InstanceUses.GetUses())
+	{
+		if (Use.Interactor && IsValidInstance(Use.Instance) && GetInstanceInteractor(Use.Instance) != Use.Interactor)
+		{
+			CurrentInteractors.Add(Use.Instance, Use.Interactor);
+			NotifyInstanceStateChanged(Use.Instance);
+		}
+	}
+}
+
+void UInteractiveInstancedBoxComponent::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+#if WITH_INTERACTION_PUSH_MODEL
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UInteractiveInstancedBoxComponent, DisabledInstanceBits, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UInteractiveInstancedBoxComponent, InstanceUses, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UInteractiveInstancedBoxComponent, InteractionEvents, Params);
+#else
+	DOREPLIFETIME(UInteractiveInstancedBoxComponent, DisabledInstanceBits);
+	DOREPLIFETIME(UInteractiveInstancedBoxComponent, InstanceUses);
+	DOREPLIFETIME(UInteractiveInstancedBoxComponent, InteractionEvents);
+#endif
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractiveLevelIndex.h"
+#include "InteractionSubsystem.h"
+#include "InteractiveBoxComponent.h"
+#include "Engine/Level.h"
+
+AInteractiveLevelIndex::AInteractiveLevelIndex()
+{
+	PrimaryActorTick.bCanEverTick = false;
+}
+
+#if WITH_EDITOR
+void AInteractiveLevelIndex::PreSave(const class ITargetPlatform* TargetPlatform)
+{
+	Super::PreSave(TargetPlatform);
+
+	// only cooked levels are indexed, editor saves keep the components registering themselves.
+	// A cook from the editor flags the loaded components too, so they're cleared again on the next editor save.
+	Rebuild(TargetPlatform != nullptr);
+}
+
+void AInteractiveLevelIndex::Rebuild(bool bIndex)
+{
+	Interactives.Reset();
+
+	const ULevel* Level = GetLevel();
+	if (Level == nullptr)
+	{
+		return;
+	}
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (Actor == nullptr || Actor->IsPendingKill() || Actor->IsEditorOnly())
+		{
+			continue;
+		}
+
+		TInlineComponentArray<UInteractiveBoxComponent*> Components(Actor);
+		for (UInteractiveBoxComponent* Interactive : Components)
+		{
+			if (Interactive->IsEditorOnly())
+			{
+				continue;
+			}
+
+			Interactive->bRegisteredByLevelIndex = bIndex;
+			if (bIndex)
+			{
+				Interactives.Add(Interactive);
+			}
+		}
+	}
+}
+#endif
+
+void AInteractiveLevelIndex::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UInteractionSubsystem* InteractionSubsystem = UInteractionSubsystem::Get(this))
+	{
+		InteractionSubsystem->AddLevelIndex(this);
+	}
+}
+
+void AInteractiveLevelIndex::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UInteractionSubsystem* InteractionSubsystem = UInteractionSubsystem::Get(this))
+	{
+		// components of a level being unloaded go away with it, don't register them now
+		InteractionSubsystem->RemoveLevelIndex(this, EndPlayReason == EEndPlayReason::Destroyed);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
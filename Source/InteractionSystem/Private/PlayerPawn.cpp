@@ -3,42 +3,81 @@
 
 #include "PlayerPawn.h"
 #include "Interactive.h"
+#include "InteractiveInstanced.h"
 #include "InteractionSystem.h"
-#include "TimerManager.h"
+#include "InteractiveBoxComponent.h"
+#include "InteractionFocusComponent.h"
+#include "InteractionSubsystem.h"
 #include "Components/InputComponent.h"
-#include "Components/PrimitiveComponent.h"
 #include "GameFramework/PlayerController.h"
-#include "Camera/PlayerCameraManager.h"
-#include "CollisionQueryParams.h"
 #include "Engine/World.h"
 #include "Engine/EngineTypes.h"
+#include "Net/UnrealNetwork.h"
 
 APlayerPawn::APlayerPawn()
 {
- 	CurrentInteractive = nullptr;
-	MaxInteractionDistance = 100.f;
+	InteractionFocus = CreateDefaultSubobject<UInteractionFocusComponent>(TEXT("InteractionFocus"));
 
+	ActiveInteractionInstance = INDEX_NONE;
+	NextInteractionCommandSequence = 0;
+	bHasInteractionCommand = false;
 }
 
 void APlayerPawn::BeginPlay()
 {
 	Super::BeginPlay();
 
-	GetWorldTimerManager().SetTimer(TimerHandle_FindInteractive,
-		this,
-		&APlayerPawn::FindInteractive,
-		0.128f, // rate
-		true, // loop
-		1.f // first delay
-	);
-	
+	// possession may happen before BeginPlay, e.g. on level start
+	UpdateFocusEnabled();
 }
 
-void APlayerPawn::Tick(float DeltaTime)
+void APlayerPawn::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::Tick(DeltaTime);
+	InteractionFocus->SetFocusEnabled(false);
 
-	TryStopInteraction();
+	FWorldDelegates::OnWorldPostActorTick.Remove(FlushInteractionCommandsHandle);
+	FlushInteractionCommandsHandle.Reset();
+	PendingInteractionCommands.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void APlayerPawn::PossessedBy(AController* NewController)
+{
+	Super::PossessedBy(NewController);
+
+	UpdateFocusEnabled();
+}
+
+void APlayerPawn::UnPossessed()
+{
+	Super::UnPossessed();
+
+	UpdateFocusEnabled();
+
+	// no more input from the old controller, so the interaction wouldn't be stopped otherwise
+	if (ActiveInteractionTarget.IsValid())
+	{
+		StopInteraction(ActiveInteractionTarget.Get(), ActiveInteractionInstance);
+	}
+	ActiveInteractionTarget.Reset();
+	ActiveInteractionInstance = INDEX_NONE;
+}
+
+void APlayerPawn::OnRep_Controller()
+{
+	Super::OnRep_Controller();
+
+	UpdateFocusEnabled();
+}
+
+void APlayerPawn::UpdateFocusEnabled()
+{
+	if (HasActorBegunPlay())
+	{
+		const APlayerController* PC = Cast<APlayerController>(GetController());
+		InteractionFocus->SetFocusEnabled(PC && PC->IsLocalController());
+	}
 }
 
 void APlayerPawn::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -59,84 +98,58 @@ void APlayerPawn::SetupPlayerInputComponent(UInputComponent* PlayerInputComponen
 
 void APlayerPawn::InteractPressed()
 {
-	Interact(GetCurrentInteractive());
+	Interact(GetCurrentInteractive(), GetCurrentInstance());
 }
 
 void APlayerPawn::InteractReleased()
 {
-	StopInteraction(GetCurrentInteractive());
+	StopInteraction(GetCurrentInteractive(), GetCurrentInstance());
+}
+
+UObject* APlayerPawn::GetCurrentInteractive() const
+{
+	return InteractionFocus->GetCurrentInteractive();
+}
+
+int32 APlayerPawn::GetCurrentInstance() const
+{
+	return InteractionFocus->GetCurrentInstance();
 }
 
-void APlayerPawn::FindInteractive()
+void APlayerPawn::Interact(UObject* Target, int32 Instance)
 {
-	UObject* Interactive = nullptr;
-	const APlayerController* PC = Cast<APlayerController>(GetController());
-	if (PC && PC->IsLocalController())
+	if (Target == nullptr)
 	{
-		const APlayerCameraManager* Camera = PC->PlayerCameraManager;
-		if (Camera)
+		return;
+	}
+	if (false == HasAuthority())
+	{
+		uint8 Sequence;
+		if (QueueInteractionCommand(Target, Instance, EInteractionCommandType::Interact, Sequence))
 		{
-			FCollisionQueryParams LineParams(SCENE_QUERY_STAT(FindInteractive), true);
-			LineParams.AddIgnoredActor(this);
-
-			// line trace
-			FHitResult OutHit;
-			const FVector TargetPoint = Camera->GetCameraLocation() + Camera->GetActorForwardVector() * MaxInteractionDistance;
-			const bool bHit = GetWorld()->LineTraceSingleByChannel(OutHit, Camera->GetCameraLocation(), TargetPoint, COLLISION_INTERACTIVE, LineParams);
-			if (bHit && OutHit.Component.IsValid() && OutHit.Component->GetClass()->ImplementsInterface(UInteractive::StaticClass()))
+			// instanced interactives don't predict
+			UInteractiveBoxComponent* InteractiveComponent = Cast<UInteractiveBoxComponent>(Target);
+			if (InteractiveComponent)
 			{
-				Interactive = Cast<UObject>(OutHit.Component);
-				if (Interactive)
-				{
-					const bool bInteractionDisabled = IInteractive::Execute_IsInteractionDisabled(Interactive);
-					if (bInteractionDisabled)
-					{
-						Interactive = nullptr;
-					}
-				}
+				InteractiveComponent->PredictInteraction(this, Sequence);
 			}
 		}
+		return;
 	}
 
-	if (Interactive != CurrentInteractive)
+	ActiveInteractionTarget = Target;
+	ActiveInteractionInstance = Instance;
+	if (Instance != INDEX_NONE)
 	{
-		// update cached value, call focus events
-		if (Interactive != nullptr)
-		{
-			IInteractive::Execute_OnFocusReceived(Interactive, this);
-		}
-		if (CurrentInteractive.IsValid())
-		{
-			// force stop interaction on focus lost, should refactor this if we want to keep the interaction active (maybe by adding a new method "ShouldStopInteraction" in IInteractive interface)
-			StopInteraction(CurrentInteractive.Get());
-			IInteractive::Execute_OnFocusLost(CurrentInteractive.Get(), this);
-		}
-		CurrentInteractive = Interactive;
-		
+		IInteractiveInstanced::Interact(Target, Instance, this);
 	}
-}
-
-void APlayerPawn::TryStopInteraction()
-{
-	if (CurrentInteractive.IsValid())
+	else
 	{
-		const bool bInteractionDisabled = IInteractive::Execute_IsInteractionDisabled(CurrentInteractive.Get());
-		if (bInteractionDisabled)
-		{
-			StopInteraction(CurrentInteractive.Get());
-			IInteractive::Execute_OnFocusLost(CurrentInteractive.Get(), this);
-			CurrentInteractive = nullptr;
-		}
+		IInteractive::Interact(Target, this);
 	}
-
 }
 
-UObject* APlayerPawn::GetCurrentInteractive() const
-{
-	return CurrentInteractive.IsValid() ? CurrentInteractive.Get() : nullptr;
-}
-
-void APlayerPawn::Interact(UObject* Target)
+void APlayerPawn::StopInteraction(UObject* Target, int32 Instance)
 {
 	if (Target == nullptr)
 	{
@@ -144,46 +157,179 @@ void APlayerPawn::Interact(UObject* Target)
 	}
 	if (false == HasAuthority())
 	{
-		ServerInteract(Target);
+		uint8 Sequence;
+		QueueInteractionCommand(Target, Instance, EInteractionCommandType::StopInteraction, Sequence);
 		return;
 	}
 
-	IInteractive::Interact(Target, this);
+	if (ActiveInteractionTarget == Target && ActiveInteractionInstance == Instance)
+	{
+		ActiveInteractionTarget.Reset();
+		ActiveInteractionInstance = INDEX_NONE;
+	}
+	if (Instance != INDEX_NONE)
+	{
+		IInteractiveInstanced::StopInteraction(Target, Instance, this);
+	}
+	else
+	{
+		IInteractive::StopInteraction(Target, this);
+	}
 }
 
-void APlayerPawn::StopInteraction(UObject* Target)
+bool APlayerPawn::QueueInteractionCommand(UObject* Target, int32 Instance, EInteractionCommandType Type, uint8& OutSequence)
 {
-	if (Target == nullptr)
+	// key spam, the same command on the same target is superseded by the pending one
+	if (PendingInteractionCommands.Num() > 0)
 	{
-		return;
+		const FInteractionCommand& LastCommand = PendingInteractionCommands.Last();
+		if (LastCommand.Target == Target && LastCommand.Instance == Instance && LastCommand.Type == Type)
+		{
+			OutSequence = LastCommand.Sequence;
+			return false;
+		}
 	}
-	if (false == HasAuthority())
+
+	FInteractionCommand& Command = PendingInteractionCommands.AddDefaulted_GetRef();
+	Command.Target = Target;
+	Command.Instance = Instance;
+	Command.Type = Type;
+	Command.Sequence = NextInteractionCommandSequence++;
+	OutSequence = Command.Sequence;
+
+	if (PendingInteractionCommands.Num() >= MaxInteractionCommandsPerBatch)
 	{
-		ServerStopInteraction(Target);
-		return;
+		FlushInteractionCommands();
 	}
+	else if (false == FlushInteractionCommandsHandle.IsValid())
+	{
+		// flush once actors ticked, input included, and before the net driver sends this frame's data
+		FlushInteractionCommandsHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &APlayerPawn::OnWorldPostActorTick);
+	}
+	return true;
+}
 
-	IInteractive::StopInteraction(Target, this);
+void APlayerPawn::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld())
+	{
+		FlushInteractionCommands();
+	}
 }
 
-bool APlayerPawn::ServerInteract_Validate(UObject* Target)
+void APlayerPawn::FlushInteractionCommands()
 {
-	return true;
+	FWorldDelegates::OnWorldPostActorTick.Remove(FlushInteractionCommandsHandle);
+	FlushInteractionCommandsHandle.Reset();
+
+	if (PendingInteractionCommands.Num() > 0)
+	{
+		ServerProcessInteractionCommands(PendingInteractionCommands);
+		PendingInteractionCommands.Reset();
+	}
 }
 
-void APlayerPawn::ServerInteract_Implementation(UObject* Target)
+bool APlayerPawn::ServerProcessInteractionCommands_Validate(const TArray<FInteractionCommand>& Commands)
 {
-	Interact(Target);
+	return Commands.Num() <= MaxInteractionCommandsPerBatch;
 }
 
-bool APlayerPawn::ServerStopInteraction_Validate(UObject* Target)
+void APlayerPawn::ServerProcessInteractionCommands_Implementation(const TArray<FInteractionCommand>& Commands)
 {
-	return true;
+	InteractionStats::RecordCommandBatch(Commands.Num());
+
+	UInteractionSubsystem* InteractionSubsystem = UInteractionSubsystem::Get(this);
+
+	// the connection, so that the limit survives respawns (there is always one for a remote client, the fallback is for direct calls)
+	const UObject* RateLimitRequester = GetNetConnection();
+	if (RateLimitRequester == nullptr)
+	{
+		RateLimitRequester = GetController() ? static_cast<const UObject*>(GetController()) : this;
+	}
+
+	for (const FInteractionCommand& Command : Commands)
+	{
+		if (bHasInteractionCommand)
+		{
+			// reliable RPCs are ordered, this only guards against duplicated or stale commands
+			if (false == Command.IsNewerThan(LastInteractionCommand.Sequence))
+			{
+				continue;
+			}
+			// superseded, e.g. interact again on the same target without stopping first
+			if (Command.Target == LastInteractionCommand.Target && Command.Instance == LastInteractionCommand.Instance && Command.Type == LastInteractionCommand.Type)
+			{
+				LastInteractionCommand.Sequence = Command.Sequence;
+				continue;
+			}
+		}
+
+		if (Command.Target && InteractionSubsystem)
+		{
+			// the stop of the active interaction is never dropped, or the interaction would never stop,
+			// other stops cost a requester token, or they would be a free way around the limit
+			const bool bStopActiveInteraction = Command.Type == EInteractionCommandType::StopInteraction
+				&& ActiveInteractionTarget == Command.Target && ActiveInteractionInstance == Command.Instance;
+			const UObject* RateLimitTarget = Command.Type == EInteractionCommandType::Interact ? Command.Target : nullptr;
+			if (false == bStopActiveInteraction && false == InteractionSubsystem->ConsumeInteractRequest(RateLimitRequester, RateLimitTarget))
+			{
+				continue;
+			}
+		}
+
+		LastInteractionCommand = Command;
+		bHasInteractionCommand = true;
+
+		// target is null if it couldn't be resolved (e.g. destroyed meanwhile)
+		if (Command.Target)
+		{
+			// events caused by this command carry its sequence, so the client can reconcile its prediction
+			FScopedInteractionPredictionKey PredictionKey(Command.Sequence);
+			if (Command.Type == EInteractionCommandType::Interact)
+			{
+				Interact(Command.Target, Command.Instance);
+			}
+			else
+			{
+				StopInteraction(Command.Target, Command.Instance);
+			}
+		}
+	}
 }
 
-void APlayerPawn::ServerStopInteraction_Implementation(UObject* Target)
+FInteractionCommand::FInteractionCommand()
+	: Target(nullptr)
+	, Type(EInteractionCommandType::Interact)
+	, Sequence(0)
+	, Instance(INDEX_NONE)
+{}
+
+bool FInteractionCommand::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
 {
-	StopInteraction(Target);
+	Map->SerializeObject(Ar, UObject::StaticClass(), Target);
+
+	uint8 bStopInteraction = Type == EInteractionCommandType::StopInteraction ? 1 : 0;
+	Ar.SerializeBits(&bStopInteraction, 1);
+	Ar.SerializeBits(&Sequence, 8);
+
+	uint8 bHasInstance = Instance != INDEX_NONE ? 1 : 0;
+	Ar.SerializeBits(&bHasInstance, 1);
+	uint32 PackedInstance = bHasInstance ? (uint32)FMath::Max(Instance, 0) : 0;
+	if (bHasInstance)
+	{
+		Ar.SerializeIntPacked(PackedInstance);
+	}
+
+	if (Ar.IsLoading())
+	{
+		Type = bStopInteraction ? EInteractionCommandType::StopInteraction : EInteractionCommandType::Interact;
+		// checked against the instance count by the target, see IInteractiveInstanced::IsValidInstance
+		Instance = bHasInstance ? (int32)FMath::Min<uint32>(PackedInstance, MAX_int32) : INDEX_NONE;
+	}
+
+	// an unresolved target is processed as null, not as a serialization error
+	bOutSuccess = true;
+	return true;
 }
 
 void APlayerPawn::MoveForward(float Value)
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* Focus candidates laid out as a structure of arrays, so they are scored 4 at a time with SIMD (see UInteractionFocusComponent cone focus mode).
+* Arrays are padded to a multiple of 4 with candidates that always score below zero.
+*/
+struct INTERACTIONSYSTEM_API FInteractionFocusCandidates
+{
+public:
+
+	void Reset();
+
+	void Add(UObject* Interactive, const FVector& Location, float Priority);
+
+	int32 Num() const { return Interactives.Num(); }
+
+	UObject* GetInteractive(int32 Index) const { return Interactives[Index]; }
+
+	FVector GetLocation(int32 Index) const { return FVector(X[Index], Y[Index], Z[Index]); }
+
+	/**
+	* Score every candidate: the closer to the view direction the better, then the closer to the view location (scaled by DistanceWeight), plus its priority.
+	* Candidates beyond MaxDistance or outside the cone of ConeHalfAngle degrees get a negative score.
+	*/
+	void Score(const FVector& ViewLocation, const FVector& ViewDirection, float MaxDistance, float ConeHalfAngle, float DistanceWeight);
+
+	/**
+	* index of the best scored candidate, INDEX_NONE if no candidate has a non negative score
+	*/
+	int32 FindBest() const;
+
+	/**
+	* exclude a candidate from FindBest, e.g. because it's disabled
+	*/
+	void Discard(int32 Index) { Scores[Index] = -1.f; }
+
+private:
+
+	TArray<UObject*> Interactives;
+
+	// padded to a multiple of 4
+	TArray<float> X;
+	TArray<float> Y;
+	TArray<float> Z;
+	TArray<float> Priorities;
+	TArray<float> Scores;
+};
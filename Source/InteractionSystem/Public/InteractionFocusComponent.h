@@ -0,0 +1,236 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "CollisionQueryParams.h"
+#include "InteractionFocusCandidates.h"
+#include "InteractionFocusComponent.generated.h"
+
+class APlayerPawn;
+class UInteractionFocusComponent;
+
+UENUM()
+enum class EInteractionFocusMode : uint8
+{
+	// the interactive hit by a line trace along the view direction
+	Trace,
+	// the best scored interactive within a cone around the view direction, see UInteractionFocusComponent::FocusConeAngle
+	Cone
+};
+
+/**
+* [local] interaction message of the focused interactive, empty if there's no focus
+*/
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnInteractionMessageChanged, UObject*, Interactive, const FText&, Message);
+
+/**
+* [local] focus detection of a player started or stopped, see UInteractionFocusComponent::SetFocusEnabled
+*/
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnInteractionFocusEnabledChanged, UInteractionFocusComponent* /* FocusComponent */, bool /* bEnabled */);
+
+/**
+* Detection of the interactive component the player is looking at (focus), and HUD message, for APlayerPawn.
+* Focus only matters to a locally controlled player, so the owning pawn enables this component only while it's possessed by a local player controller
+* (see APlayerPawn::UpdateFocusEnabled). Otherwise, i.e. on dedicated server, for simulated proxies and AI, it does nothing at all:
+* it's not registered for focus updates, and it never ticks.
+*/
+UCLASS(ClassGroup = InteractionSystem)
+class INTERACTIONSYSTEM_API UInteractionFocusComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UInteractionFocusComponent();
+
+	//~ Begin UActorComponent Interface
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	//~ End UActorComponent Interface
+
+	/**
+	* Start or stop focus detection. Stopping drops focus, which stops the current interaction too.
+	*/
+	void SetFocusEnabled(bool bEnabled);
+
+	bool IsFocusEnabled() const { return bFocusEnabled; }
+
+	/**
+	* [local] Fires when the focus of any player is enabled or disabled, i.e. when a local player controller possesses or unpossesses a pawn,
+	* so that the HUD can follow the possessed pawn (see UInteractionHUDWidget).
+	*/
+	static FOnInteractionFocusEnabledChanged OnFocusEnabledChanged;
+
+	/**
+	Get the interactive component the player is looking at if any, or nullptr otherwise.
+	This is intended for locally controlled players only to handle HUD stuff, non-locally controlled players will always return nullptr.
+	*/
+	UFUNCTION(BlueprintCallable)
+	UObject* GetCurrentInteractive() const;
+
+	/**
+	* Get the focused instance of the current interactive if it's instanced (see IInteractiveInstanced), INDEX_NONE otherwise.
+	*/
+	UFUNCTION(BlueprintCallable)
+	int32 GetCurrentInstance() const;
+
+	/**
+	* Get the cached interaction message of the current interactive, empty if there's none. The message is computed again only when focus
+	* or the interaction state changes (or periodically, for interactives that can't notify it, see InteractionStatePollInterval),
+	* so bind OnInteractionMessageChanged rather than polling this.
+	*/
+	UFUNCTION(BlueprintCallable)
+	const FText& GetInteractionMessage() const;
+
+	/**
+	* [local] Fires when focus changes, or when the focused interactive state changes and its message is different, intended for the HUD.
+	*/
+	UPROPERTY(BlueprintAssignable)
+	FOnInteractionMessageChanged OnInteractionMessageChanged;
+
+	float GetMaxInteractionDistance() const { return MaxInteractionDistance; }
+
+	/**
+	* trace for an enabled interactive component (or instance) from view location, up to MaxInteractionDistance
+	*/
+	UObject* TraceInteractive(const FVector& ViewLocation, const FVector& ViewDirection, int32& OutInstance) const;
+
+	/**
+	* [local] call focus events if the focused interactive (or instance) changed
+	*/
+	void UpdateFocus(UObject* Interactive, int32 Instance = INDEX_NONE);
+
+protected:
+
+	UPROPERTY(EditDefaultsOnly, Category = InteractionSystem)
+	float MaxInteractionDistance;
+
+	/**
+	* If true, the focus trace is asynchronous: it's batched with the other local players' traces (see UInteractionSubsystem),
+	* and focus is updated on the next frame when the result comes in. Otherwise it's a blocking trace on the game thread.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = InteractionSystem)
+	bool bAsyncFocusTrace;
+
+	/**
+	* Trace is a thin line trace, precise but unforgiving with small or crowded interactives.
+	* Cone gathers the registered interactives in range (see UInteractionSubsystem registry), scores them by angle, distance and
+	* UInteractiveBoxComponent::FocusPriority, and only the winner gets a visibility trace. bAsyncFocusTrace applies to Trace mode only.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = InteractionSystem)
+	EInteractionFocusMode FocusMode;
+
+	/**
+	* cone focus mode half angle, in degrees
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = InteractionSystem, meta = (ClampMin = "0.0", ClampMax = "89.0"))
+	float FocusConeAngle;
+
+	/**
+	* cone focus mode weight of the distance score, against an angle score from 0 (cone edge) to 1 (view direction)
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = InteractionSystem, meta = (ClampMin = "0.0"))
+	float FocusDistanceWeight;
+
+	/**
+	* interval of the fallback polling of the focused interactive state, only for interactives that may not notify its changes (see IInteractive::ShouldPollInteractionState)
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = InteractionSystem, meta = (ClampMin = "0.01"))
+	float InteractionStatePollInterval;
+
+private:
+
+	bool bFocusEnabled;
+
+	TWeakObjectPtr<UObject> CurrentInteractive;
+
+	// see GetCurrentInstance
+	int32 CurrentInstance;
+
+	FTimerHandle TimerHandle_FindInteractive;
+
+	FTimerHandle TimerHandle_PollInteractionState;
+
+	FDelegateHandle InteractionAvailabilityChangedHandle;
+
+	FDelegateHandle InteractionStateChangedHandle;
+
+	FText InteractionMessage;
+
+	// scratch, reused across updates
+	FInteractionFocusCandidates FocusCandidates;
+
+	APlayerPawn* GetPlayerPawn() const;
+
+	/**
+	* the local player controller of the owning pawn, if any
+	*/
+	class APlayerController* GetLocalPlayerController() const;
+
+	void FindInteractive();
+
+	/**
+	* camera view of the local player, false if not locally controlled, see UInteractionSubsystem::RegisterFocusSource
+	*/
+	bool GetFocusView(FVector& OutLocation, FRotator& OutRotation);
+
+	/**
+	* best scored enabled interactive in the focus cone which is not occluded, see FocusMode. Registered interactives only, so never an instance
+	*/
+	UObject* FindInteractiveInCone(const FVector& ViewLocation, const FVector& ViewDirection, int32& OutInstance);
+
+	/**
+	* request an async trace from view location, up to MaxInteractionDistance, false if it can't be requested
+	*/
+	bool RequestTraceInteractive(const FVector& ViewLocation, const FVector& ViewDirection);
+
+	void OnTraceInteractiveCompleted(const FHitResult* Hit);
+
+	FCollisionQueryParams GetTraceInteractiveParams() const;
+
+	/**
+	* get the hit interactive component if it's enabled, nullptr otherwise. OutInstance is the hit instance of an instanced interactive (FHitResult::Item).
+	*/
+	UObject* GetInteractiveFromHit(const FHitResult& Hit, int32& OutInstance) const;
+
+	/**
+	* update the cached interactive, and (un)subscribe to its availability notification
+	*/
+	void SetCurrentInteractive(UObject* Interactive, int32 Instance = INDEX_NONE);
+
+	/**
+	* IInteractive::IsInteractionDisabled, or IInteractiveInstanced::IsInstanceInteractionDisabled for an instance
+	*/
+	static bool IsTargetInteractionDisabled(UObject* Interactive, int32 Instance);
+
+	/**
+	* fire the focus received or lost event of the interactive, or of the instance
+	*/
+	void NotifyFocus(UObject* Interactive, int32 Instance, bool bReceived);
+
+	/**
+	* IInteractive::ShouldPollInteractionState, or IInteractiveInstanced::ShouldPollInstanceState for an instance
+	*/
+	static bool ShouldPollTargetState(UObject* Interactive, int32 Instance);
+
+	/**
+	* fallback for the current interactive state changes that are not notified, see InteractionStatePollInterval
+	*/
+	void PollInteractionState();
+
+	void OnInteractionAvailabilityChanged(UObject* Interactive, bool bDisabled);
+
+	void OnInteractionStateChanged(UObject* Interactive);
+
+	void OnInstanceInteractionAvailabilityChanged(UObject* Interactive, int32 Instance, bool bDisabled);
+
+	void OnInstanceInteractionStateChanged(UObject* Interactive, int32 Instance);
+
+	/**
+	* compute the message of the current interactive again, broadcast it if it changed or focus changed
+	*/
+	void UpdateInteractionMessage(bool bFocusChanged = false);
+
+	void TryStopInteraction();
+};
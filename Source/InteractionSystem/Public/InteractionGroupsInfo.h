@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "InteractionGroupsInfo.generated.h"
+
+/**
+* Table of the interaction groups of a world (see UInteractiveBoxComponent::InteractionGroup), spawned on server on demand and replicated to everyone.
+* Group names are only appended, so a group index never changes, and the disabled state of all groups is a single bitset (32 groups per word).
+* Disabling a whole group (e.g. a power outage) is then a single bit change on a single actor channel,
+* instead of a replicated property update on every interactive component of the group.
+* Use it through UInteractionSubsystem.
+*/
+UCLASS(NotPlaceable)
+class INTERACTIONSYSTEM_API AInteractionGroupsInfo : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+
+	AInteractionGroupsInfo();
+
+	//~ Begin UObject Interface
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	//~ End UObject Interface
+
+	//~ Begin AActor Interface
+	virtual void PostInitializeComponents() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	//~ End AActor Interface
+
+	/**
+	* index of Group, INDEX_NONE if unknown (e.g. not replicated yet)
+	*/
+	int32 FindGroup(FName Group) const { return GroupNames.IndexOfByKey(Group); }
+
+	/**
+	* [server] index of Group, added if unknown
+	*/
+	int32 FindOrAddGroup(FName Group);
+
+	bool IsGroupDisabled(int32 GroupIndex) const
+	{
+		const int32 Word = GroupIndex >> 5;
+		return GroupIndex >= 0 && Word < DisabledGroupBits.Num() && (DisabledGroupBits[Word] & (1u << (GroupIndex & 31))) != 0;
+	}
+
+	/**
+	* [server] enable or disable every interactive of the group at once
+	*/
+	void SetGroupDisabled(int32 GroupIndex, bool bDisabled);
+
+private:
+
+	UPROPERTY(Replicated)
+	TArray<FName> GroupNames;
+
+	UPROPERTY(ReplicatedUsing = OnRep_DisabledGroupBits)
+	TArray<uint32> DisabledGroupBits;
+
+	UFUNCTION()
+	void OnRep_DisabledGroupBits(const TArray<uint32>& OldDisabledGroupBits);
+
+	/**
+	* let the interactives of the groups whose bit changed notify their availability
+	*/
+	void NotifyGroupsChanged(const TArray<uint32>& OldDisabledGroupBits);
+};
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "InteractionHUDWidget.generated.h"
+
+class UTextBlock;
+class UInteractionFocusComponent;
+
+/**
+* Player HUD: the interaction message of the focused interactive, and the net mode.
+* Event driven, nothing is polled per frame: the message is set when UInteractionFocusComponent::OnInteractionMessageChanged fires
+* for the pawn the owning player possesses, and the net mode once on construct.
+* A widget blueprint can subclass it for its layout by naming its text blocks Text_Interaction and Text_NetMode, otherwise a default layout is built.
+*/
+UCLASS()
+class INTERACTIONSYSTEM_API UInteractionHUDWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+
+	//~ Begin UUserWidget Interface
+	virtual bool Initialize() override;
+	//~ End UUserWidget Interface
+
+protected:
+
+	//~ Begin UUserWidget Interface
+	virtual void NativeConstruct() override;
+	virtual void NativeDestruct() override;
+	//~ End UUserWidget Interface
+
+	UPROPERTY(BlueprintReadOnly, Category = InteractionSystem, meta = (BindWidgetOptional))
+	UTextBlock* Text_Interaction;
+
+	UPROPERTY(BlueprintReadOnly, Category = InteractionSystem, meta = (BindWidgetOptional))
+	UTextBlock* Text_NetMode;
+
+private:
+
+	// focus component of the pawn the owning player possesses, while its focus is enabled
+	TWeakObjectPtr<UInteractionFocusComponent> InteractionFocus;
+
+	FDelegateHandle FocusEnabledChangedHandle;
+
+	/**
+	* Build the default layout, for the native class only (a widget blueprint subclass comes with its own tree).
+	*/
+	void BuildDefaultWidgetTree();
+
+	/**
+	* Follow the interaction message of NewInteractionFocus, or clear it if nullptr.
+	*/
+	void BindInteractionFocus(UInteractionFocusComponent* NewInteractionFocus);
+
+	void OnFocusEnabledChanged(UInteractionFocusComponent* FocusComponent, bool bEnabled);
+
+	UFUNCTION()
+	void OnInteractionMessageChanged(UObject* Interactive, const FText& Message);
+};
@@ -0,0 +1,451 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/World.h"
+#include "Engine/EngineBaseTypes.h"
+#include "CollisionQueryParams.h"
+#include "ConvexVolume.h"
+#include "InteractionTimerWheel.h"
+#include "InteractionSubsystem.generated.h"
+
+/**
+* called with the blocking hit of a focus trace, or nullptr if nothing was hit
+*/
+DECLARE_DELEGATE_OneParam(FOnFocusTraceCompleted, const FHitResult* /*Hit*/);
+
+class UInteractiveBoxComponent;
+class AInteractionGroupsInfo;
+class AInteractiveLevelIndex;
+class APawn;
+struct FInteractionFocusCandidates;
+
+/**
+* get the current view of a focus source, false if it has no view (e.g. not locally controlled)
+*/
+DECLARE_DELEGATE_RetVal_TwoParams(bool, FGetFocusView, FVector& /*OutLocation*/, FRotator& /*OutRotation*/);
+
+/**
+* An AI agent looking for something to interact with, see UInteractionSubsystem::InteractForAgents
+*/
+USTRUCT(BlueprintType)
+struct FInteractionAgentQuery
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	FInteractionAgentQuery();
+
+	UPROPERTY(BlueprintReadWrite, Category = InteractionSystem)
+	APawn* Agent;
+
+	UPROPERTY(BlueprintReadWrite, Category = InteractionSystem)
+	FVector Location;
+
+	/**
+	* facing, normalized
+	*/
+	UPROPERTY(BlueprintReadWrite, Category = InteractionSystem)
+	FVector Direction;
+
+	/**
+	* max distance (cm) to the interactive
+	*/
+	UPROPERTY(BlueprintReadWrite, Category = InteractionSystem)
+	float Reach;
+
+	/**
+	* half angle (degrees, up to 89) around Direction within which interactives are considered
+	*/
+	UPROPERTY(BlueprintReadWrite, Category = InteractionSystem)
+	float ConeHalfAngle;
+};
+
+/**
+* Shared services of the interaction system, for the world of the owning game instance.
+* This is a game instance subsystem since world subsystems don't exist before 4.24, and a game instance has one world at a time.
+*
+* Async focus traces: focus queries requested during the frame (all local players, see UInteractionFocusComponent::bAsyncFocusTrace) are gathered
+* and submitted together once actors ticked, through the world async trace buffer, so they run in parallel off the game thread.
+* Results are delivered on the next frame, before actors tick.
+*
+* Focus scheduling: instead of tracing at a fixed rate, a focus source (e.g. a player) is updated only when its view moved or rotated
+* beyond a threshold, when an interactive component within its range moved, was registered or unregistered, or had its availability changed,
+* or when FocusMaxInterval elapsed. So an idle player barely traces,
+* and a player turning fast traces every frame. No more than MaxFocusUpdatesPerFrame sources are updated per frame, the most changed first.
+*
+* Registry: interactive components register themselves (OnRegister/OnUnregister) and keep their entry up to date when they move.
+* Components of a level with an AInteractiveLevelIndex are added by the index instead, LevelIndexEntriesPerFrame per frame along with their physics state,
+* so level streaming doesn't spike.
+* Entries are packed in flat arrays and bucketed by bounds center in a 3D spatial hash of RegistryCellSize cells,
+* so radius, box and frustum queries don't touch the physics scene. Entries larger than a quarter of a cell are kept aside and tested by every query.
+*
+* AI queries: a batch of agents (e.g. hundreds of NPCs opening doors) is matched against the registry in parallel on worker threads,
+* scored like the cone focus mode of players. Workers only read the registry arrays, which don't change while the game thread waits for them,
+* and the interactions are then started on the game thread.
+*
+* Rate limiting: interact requests from remote players go through a token bucket per connection and per interactive (see ConsumeInteractRequest),
+* so that a spamming client can't make the server run interaction logic (blueprints included) more often than configured.
+*
+* Interaction groups: enable or disable every interactive of a named group at once (see UInteractiveBoxComponent::InteractionGroup),
+* the state of all groups is replicated as a bitset by AInteractionGroupsInfo.
+*
+* Timers: a single hierarchical timer wheel (see FInteractionTimerWheel) shared by all interactives, e.g. for press-and-hold interactions,
+* advanced once per frame after actors ticked. Its cost doesn't depend on the number of pending timers.
+*/
+UCLASS(Config = Game)
+class INTERACTIONSYSTEM_API UInteractionSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	UInteractionSubsystem();
+
+	/**
+	* get the subsystem of the game instance owning this object world, if any
+	*/
+	static UInteractionSubsystem* Get(const UObject* WorldContextObject);
+
+	//~ Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+	/**
+	* Request a single line trace on COLLISION_INTERACTIVE channel, submitted at the end of this frame with the other requests.
+	* A Requester has at most one pending request, a new one replaces it (the callback of the replaced request is not called).
+	* The callback is called on the next frame, unless the world is torn down meanwhile.
+	*/
+	void RequestFocusTrace(const UObject* Requester, const FVector& Start, const FVector& End, const FCollisionQueryParams& Params, FOnFocusTraceCompleted&& Callback);
+
+	/**
+	* drop the pending request of Requester, in flight traces are not affected but their callback won't be called
+	*/
+	void CancelFocusTrace(const UObject* Requester);
+
+	/**
+	* Schedule focus updates for Source, see focus scheduling above. UpdateFocus is called once registered, and then on demand, at the end of the frame.
+	* Range is the focus distance, interactive components that move farther than that from the view don't trigger an update.
+	*/
+	void RegisterFocusSource(const UObject* Source, float Range, FGetFocusView&& GetView, FSimpleDelegate&& UpdateFocus);
+
+	void UnregisterFocusSource(const UObject* Source);
+
+	/**
+	* [interactive components] add to the registry, see registry above
+	*/
+	void RegisterInteractive(UInteractiveBoxComponent* Interactive);
+
+	void UnregisterInteractive(UInteractiveBoxComponent* Interactive);
+
+	/**
+	* [interactive components] an interactive moved, update its registry entry, focus sources in range of its old and new bounds will be updated
+	*/
+	void UpdateInteractive(UInteractiveBoxComponent* Interactive);
+
+	/**
+	* [interactive components] something changed within the bounds (e.g. an interactive availability), focus sources in range will be updated
+	*/
+	void MarkFocusDirty(const FBox& Bounds);
+
+	/**
+	* [level index] add the interactives of the index to the registry, over the next frames
+	*/
+	void AddLevelIndex(AInteractiveLevelIndex* LevelIndex);
+
+	/**
+	* [level index] stop adding the interactives of the index. If bAddRemainingEntries, the ones not added yet are added right away,
+	* e.g. the index was destroyed but its level stays loaded, otherwise they'd never be registered nor get a physics state.
+	*/
+	void RemoveLevelIndex(AInteractiveLevelIndex* LevelIndex, bool bAddRemainingEntries);
+
+	/**
+	* all registered interactives, in no particular order
+	*/
+	const TArray<UInteractiveBoxComponent*>& GetInteractives() const { return EntryComponents; }
+
+	/**
+	* add to OutInteractives the registered interactives whose bounds are within Radius of Center
+	*/
+	void QueryInteractivesInRadius(const FVector& Center, float Radius, TArray<UInteractiveBoxComponent*>& OutInteractives) const;
+
+	/**
+	* add to OutInteractives the registered interactives whose bounds intersect Box
+	*/
+	void QueryInteractivesInBox(const FBox& Box, TArray<UInteractiveBoxComponent*>& OutInteractives) const;
+
+	/**
+	* Add to OutInteractives the registered interactives whose bounds intersect Frustum (e.g. a view frustum, see GetViewFrustumBounds).
+	* FrustumBounds limits the cells to visit, all entries are tested if it's not valid (i.e. unbounded frustum).
+	*/
+	void QueryInteractivesInFrustum(const FConvexVolume& Frustum, const FBox& FrustumBounds, TArray<UInteractiveBoxComponent*>& OutInteractives) const;
+
+	/**
+	* Best interactive of each agent (the closest to its facing within its reach, plus focus priority), nullptr if there's none.
+	* Candidates are found in parallel (see AI queries above), and the ones whose interaction is disabled are skipped on the game thread,
+	* where the remaining candidates of an agent are ranked too if all of its best ones are disabled. OutInteractives matches Queries, index for index.
+	*/
+	void FindInteractivesForAgents(const TArray<FInteractionAgentQuery>& Queries, TArray<UInteractiveBoxComponent*>& OutInteractives) const;
+
+	/**
+	* [server] FindInteractivesForAgents, then interact with the best interactive of each agent (IInteractive::Interact).
+	* Agents must stop their interaction themselves (IInteractive::StopInteraction), e.g. once the door is open.
+	*/
+	UFUNCTION(BlueprintCallable, Category = InteractionSystem)
+	void InteractForAgents(const TArray<FInteractionAgentQuery>& Queries, TArray<UInteractiveBoxComponent*>& OutInteractives);
+
+	/**
+	* [server] Take a token from the bucket of Requester (e.g. a connection) and from the bucket of Target, false if either is empty:
+	* the request must then be dropped, before any interface dispatch. See rate limiting above.
+	* Target can be null (e.g. a stop command), only the requester bucket is used then.
+	*/
+	bool ConsumeInteractRequest(const UObject* Requester, const UObject* Target);
+
+	/**
+	* [server] requests dropped so far because of the requester limit, and because of the interactive limit
+	*/
+	int64 GetNumDroppedByRequester() const { return NumDroppedByRequester; }
+
+	int64 GetNumDroppedByInteractive() const { return NumDroppedByInteractive; }
+
+	/**
+	* [server] Enable or disable every interactive whose InteractionGroup is Group, e.g. for a power outage. It's a single bit to replicate.
+	*/
+	UFUNCTION(BlueprintCallable, Category = InteractionSystem)
+	void SetInteractionGroupDisabled(FName Group, bool bDisabled);
+
+	/**
+	* [local + server]
+	*/
+	UFUNCTION(BlueprintCallable, Category = InteractionSystem)
+	bool IsInteractionGroupDisabled(FName Group) const;
+
+	/**
+	* [local + server] index of Group, INDEX_NONE if unknown or not replicated yet
+	*/
+	int32 FindInteractionGroup(FName Group) const;
+
+	bool IsInteractionGroupDisabled(int32 GroupIndex) const;
+
+	/**
+	* [groups info] the replicated groups table spawned or received, or nullptr (Expected only clears it if it's the current one)
+	*/
+	void SetInteractionGroupsInfo(AInteractionGroupsInfo* GroupsInfo, AInteractionGroupsInfo* Expected = nullptr);
+
+	/**
+	* [groups info] let the registered interactives of the changed groups notify their availability
+	*/
+	void NotifyInteractionGroupsChanged(const TArray<uint32>& ChangedGroupBits);
+
+	/**
+	* [game thread] timers of the interactives, see timers above
+	*/
+	FInteractionTimerWheel& GetTimerWheel() { return TimerWheel; }
+
+protected:
+
+	/**
+	* minimum view movement (cm) that triggers a focus update
+	*/
+	UPROPERTY(Config)
+	float FocusLocationThreshold;
+
+	/**
+	* minimum view rotation (degrees) that triggers a focus update
+	*/
+	UPROPERTY(Config)
+	float FocusAngleThreshold;
+
+	/**
+	* maximum seconds between two updates of the same source, e.g. for occluders that moved in between
+	*/
+	UPROPERTY(Config)
+	float FocusMaxInterval;
+
+	/**
+	* per-frame budget, sources that didn't make it are updated first on the next frame
+	*/
+	UPROPERTY(Config)
+	int32 MaxFocusUpdatesPerFrame;
+
+	/**
+	* registry spatial hash cell size (cm), a few times the typical query radius
+	*/
+	UPROPERTY(Config)
+	float RegistryCellSize;
+
+	/**
+	* timer wheel tick (seconds), timers fire up to that late
+	*/
+	UPROPERTY(Config)
+	float TimerWheelResolution;
+
+	/**
+	* level index entries added to the registry (and given a physics state) per frame, see registry above
+	*/
+	UPROPERTY(Config)
+	int32 LevelIndexEntriesPerFrame;
+
+	/**
+	* interact requests a connection can send at once, and then per second, 0 rate for no limit
+	*/
+	UPROPERTY(Config)
+	float RequesterRateLimitBurst;
+
+	UPROPERTY(Config)
+	float RequesterRateLimitRate;
+
+	/**
+	* interact requests an interactive accepts at once from all connections, and then per second, 0 rate for no limit
+	*/
+	UPROPERTY(Config)
+	float InteractiveRateLimitBurst;
+
+	UPROPERTY(Config)
+	float InteractiveRateLimitRate;
+
+private:
+
+	struct FFocusSource
+	{
+		TWeakObjectPtr<const UObject> Source;
+		float Range;
+		FGetFocusView GetView;
+		FSimpleDelegate UpdateFocus;
+		FVector LastLocation;
+		FQuat LastRotation;
+		float LastUpdateTime;
+		bool bNeverUpdated;
+	};
+
+	TArray<FFocusSource> FocusSources;
+
+	// bounds of interactives that moved, were added or removed, or changed availability since the last schedule, see MarkFocusDirty
+	TArray<FBox> ChangedInteractiveBounds;
+
+	void ScheduleFocusUpdates(UWorld* World);
+
+	// registry entries, structure of arrays so that queries only walk bounds
+	TArray<FBox> EntryBounds;
+	TArray<FIntVector> EntryCells;
+	TArray<UInteractiveBoxComponent*> EntryComponents;
+	TArray<float> EntryPriorities;
+
+	TMap<const UInteractiveBoxComponent*, int32> EntryIndices;
+
+	// entry indices by cell of their bounds center
+	TMap<FIntVector, TArray<int32, TInlineAllocator<4>>> Cells;
+
+	// entries too large to be bucketed, see GetEntryCell
+	TArray<int32> OversizedEntries;
+
+	// EntryCells value of the oversized entries
+	static const FIntVector OversizedCell;
+
+	/**
+	* cell of the bounds center, or OversizedCell if the bounds extent is more than GetMaxCellEntryExtent
+	*/
+	FIntVector GetEntryCell(const FBox& Bounds) const;
+
+	/**
+	* largest extent of a bucketed entry, queries are expanded by this so that entries bucketed in a neighbour cell by their center are not missed
+	*/
+	float GetMaxCellEntryExtent() const { return FMath::Max(RegistryCellSize, 1.f) * 0.25f; }
+
+	struct FPendingLevelIndex
+	{
+		TWeakObjectPtr<AInteractiveLevelIndex> LevelIndex;
+		int32 NextEntry;
+	};
+
+	// level indices being added, oldest first
+	TArray<FPendingLevelIndex> PendingLevelIndices;
+
+	/**
+	* add the next LevelIndexEntriesPerFrame entries of the pending level indices
+	*/
+	void MergeLevelIndices();
+
+	/**
+	* register the interactives of the index from FirstEntry to LastEntry (excluded), and create their physics state
+	*/
+	void AddLevelIndexEntries(const AInteractiveLevelIndex& LevelIndex, int32 FirstEntry, int32 LastEntry);
+
+	FIntVector GetCell(const FVector& Location) const;
+
+	void AddToCell(int32 Index, const FIntVector& Cell);
+
+	void RemoveFromCell(int32 Index, const FIntVector& Cell);
+
+	/**
+	* add and score the registered interactives within reach of the agent, see FindInteractivesForAgents
+	*/
+	void GatherAgentCandidates(const FInteractionAgentQuery& Query, FInteractionFocusCandidates& OutCandidates) const;
+
+	/**
+	* call Visitor with the index of each entry bucketed in the cells overlapping Box (expanded by GetMaxCellEntryExtent), and of each oversized entry
+	*/
+	template<typename VisitorType>
+	void ForEachEntryInBox(const FBox& Box, VisitorType&& Visitor) const;
+
+	struct FFocusTraceRequest
+	{
+		TWeakObjectPtr<const UObject> Requester;
+		TWeakObjectPtr<UWorld> World;
+		FVector Start;
+		FVector End;
+		FCollisionQueryParams Params;
+		FOnFocusTraceCompleted Callback;
+	};
+
+	// requested this frame, not submitted yet
+	TArray<FFocusTraceRequest> PendingFocusTraces;
+
+	// submitted, waiting for results (key is the trace user data)
+	TMap<uint32, FFocusTraceRequest> InFlightFocusTraces;
+
+	uint32 NextFocusTraceId;
+
+	struct FTokenBucket
+	{
+		float Tokens;
+		double LastRefillTime;
+	};
+
+	TMap<TWeakObjectPtr<const UObject>, FTokenBucket> RequesterBuckets;
+	TMap<TWeakObjectPtr<const UObject>, FTokenBucket> InteractiveBuckets;
+
+	double LastBucketsPruneTime;
+
+	int64 NumDroppedByRequester;
+	int64 NumDroppedByInteractive;
+
+	/**
+	* refilled tokens of the bucket of Key (a full bucket if there's none yet), the bucket is added if missing
+	*/
+	static FTokenBucket& RefillBucket(TMap<TWeakObjectPtr<const UObject>, FTokenBucket>& Buckets, const UObject* Key, double Now, float Burst, float Rate);
+
+	/**
+	* forget the buckets that refilled, and the ones of destroyed objects
+	*/
+	void PruneBuckets(double Now);
+
+	UPROPERTY(Transient)
+	AInteractionGroupsInfo* InteractionGroupsInfo;
+
+	FInteractionTimerWheel TimerWheel;
+
+	FTraceDelegate FocusTraceDelegate;
+
+	FDelegateHandle PostActorTickHandle;
+
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void SubmitFocusTraces(UWorld* World);
+
+	void OnFocusTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+};
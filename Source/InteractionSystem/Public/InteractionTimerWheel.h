@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* Handle of a timer in FInteractionTimerWheel, it gets stale once the timer fired or has been removed
+*/
+struct FInteractionTimerHandle
+{
+	FInteractionTimerHandle()
+		: Index(INDEX_NONE)
+		, Serial(0)
+	{}
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+
+	void Invalidate() { Index = INDEX_NONE; }
+
+private:
+
+	friend struct FInteractionTimerWheel;
+
+	int32 Index;
+	uint32 Serial;
+};
+
+/**
+* Hierarchical timer wheel, with a resolution of TickInterval seconds.
+* Level 0 has 256 slots of one tick each, the 3 upper levels have 64 slots each spanning a full turn of the level below,
+* so the wheel covers 2^26 ticks (a few weeks at 30Hz). Timers live in a pool and each slot is an intrusive linked list.
+* Add and Remove are O(1), and so is a tick: a timer is moved down a level at most once per level, and then fired.
+* Timers are meant to be driven by the game thread, e.g. through UInteractionSubsystem::GetTimerWheel.
+*/
+struct INTERACTIONSYSTEM_API FInteractionTimerWheel
+{
+public:
+
+	explicit FInteractionTimerWheel(float InTickInterval = 1.f / 30.f);
+
+	/**
+	* remove all timers without firing them, and change the resolution
+	*/
+	void Reset(float InTickInterval);
+
+	/**
+	* add a timer that fires Callback in Delay seconds, rounded up to the next tick
+	*/
+	FInteractionTimerHandle Add(float Delay, FSimpleDelegate&& Callback);
+
+	/**
+	* remove the timer if it's still pending, the handle is invalidated in any case
+	*/
+	bool Remove(FInteractionTimerHandle& Handle);
+
+	bool IsPending(const FInteractionTimerHandle& Handle) const;
+
+	/**
+	* seconds before the timer fires, 0 if it's not pending
+	*/
+	float GetRemaining(const FInteractionTimerHandle& Handle) const;
+
+	/**
+	* advance time, firing the timers that expire, in expiration order
+	*/
+	void Advance(float DeltaSeconds);
+
+	/**
+	* number of pending timers
+	*/
+	int32 Num() const { return NumPending; }
+
+private:
+
+	static const int32 Level0Bits = 8;
+	static const int32 LevelBits = 6;
+	static const int32 NumLevels = 4;
+	static const int32 Level0Slots = 1 << Level0Bits;
+	static const int32 LevelSlots = 1 << LevelBits;
+	static const int32 NumSlots = Level0Slots + (NumLevels - 1) * LevelSlots;
+	static const uint64 MaxTicks = (1ull << (Level0Bits + (NumLevels - 1) * LevelBits)) - 1;
+
+	struct FTimer
+	{
+		FSimpleDelegate Callback;
+		uint64 ExpireTick;
+		int32 Slot;
+		int32 Prev;
+		int32 Next;
+		uint32 Serial;
+	};
+
+	TArray<FTimer> Timers;
+
+	TArray<int32> FreeTimers;
+
+	// head timer of each slot list, level 0 slots first
+	int32 SlotHeads[NumSlots];
+
+	float TickInterval;
+
+	float Accumulator;
+
+	uint64 CurrentTick;
+
+	int32 NumPending;
+
+	int32 GetSlot(uint64 ExpireTick) const;
+
+	void Link(int32 TimerIndex);
+
+	void Unlink(int32 TimerIndex);
+
+	/**
+	* move the timers of an upper level slot down to their slot for the current tick
+	*/
+	void Cascade(int32 Slot);
+
+	void Tick();
+};
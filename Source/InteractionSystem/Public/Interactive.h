@@ -8,6 +8,18 @@
 
 class APawn;
 
+/**
+* Fires when the interaction availability of an interactive object changes, i.e. when IsInteractionDisabled may return a different value.
+* Params are the interactive object and its new disabled state.
+*/
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnInteractionAvailabilityChanged, UObject* /* Interactive */, bool /* bDisabled */);
+
+/**
+* Fires when the interaction state of an interactive object changes, i.e. when GetMessage may return a different value
+* (interaction started or stopped, availability changed, or the implementation says so). Param is the interactive object.
+*/
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnInteractionStateChanged, UObject* /* Interactive */);
+
 /**
 * Implement this interface in a component of an actor that should handle player interaction (e.g. light switches, doors, levers, etc.).
 * In order for the player to detect an interactive component, the component must have a collision setup that blocks "Interactive" trace channel. 
@@ -18,6 +30,8 @@ class APawn;
 *
 * You can find an implementation of this interface in UInteractiveBoxComponent, which you can subclass or use directly as a component of your actor. 
 *
+* For many identical interactives (e.g. hundreds of switches), see IInteractiveInstanced, which hosts them as instances of a single component.
+*
 * See UInteractiveBoxComponent
 * See IInteractiveActor
 * See PlayerPawn (for interactive component detection)
@@ -52,7 +66,7 @@ protected:
 	* interaction is disabled (IsInteractionDisabled returns true);
 	* when locally controlled player aborts interaction (i.e. when button on keyboard is released).
 	*
-	* You'll likely need this for press and hold functionality.
+	* For press and hold, UInteractiveBoxComponent::HoldDuration times the hold on server and fires the completion or cancelation for you.
 	*/
 	UFUNCTION(BlueprintNativeEvent)
 	void OnStopInteraction(APawn* Interactor);
@@ -99,4 +113,23 @@ public:
 	*/
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable)
 	bool IsInteractionDisabled() const;
+
+	/**
+	* [local + server] Notification fired when IsInteractionDisabled changes, so that players can drop focus as soon as interaction is disabled, 
+	* instead of polling IsInteractionDisabled every frame. Implementations that don't support it return nullptr.
+	*/
+	virtual FOnInteractionAvailabilityChanged* GetOnInteractionAvailabilityChanged() { return nullptr; }
+
+	/**
+	* [local] Can the interaction state change without the notifications being fired? e.g. IsInteractionDisabled or GetMessage is implemented in blueprint
+	* by an actor that doesn't call UInteractiveBoxComponent::NotifyInteractionAvailabilityChanged or NotifyInteractionStateChanged.
+	* If true, the focus component polls them at a low rate while focused.
+	*/
+	virtual bool ShouldPollInteractionState() const { return true; }
+
+	/**
+	* [local] Notification fired when the interaction state changes, so that the HUD message is computed again only then,
+	* instead of calling GetMessage every frame. Implementations that don't support it return nullptr.
+	*/
+	virtual FOnInteractionStateChanged* GetOnInteractionStateChanged() { return nullptr; }
 };
@@ -19,6 +19,12 @@ class APawn;
 * The validation functions are CanInteract and IsInteractionDisabled. Please note that you must not call the IInteractive "counterpart" from the
 * actor function, e.g. calling component's CanInteract from actor's CanInteract, will result in an infinite loop.
 * That happens because the functions in InteractiveBoxComponent call the matching functions in the actor, if the actor implementation is used (see UInteractiveBoxComponent.cpp).
+* When the actor implementation is used, the component evaluates IsInteractionDisabled and GetMessage again after each interaction event,
+* and when the owner timelines playing then end, and notifies players of the changes (see UInteractiveBoxComponent::bPollActorInteractionState).
+* If they may change some other way, the actor must call UInteractiveBoxComponent::NotifyInteractionAvailabilityChanged whenever IsInteractionDisabled
+* may return a different value, on server and on clients (e.g. from the rep notify of the replicated state), so players can drop focus immediately.
+* Likewise, it must call UInteractiveBoxComponent::NotifyInteractionStateChanged whenever GetMessage depends on some other state which changed,
+* otherwise the HUD message is only polled if bPollActorInteractionState is set.
 */
 UINTERFACE(MinimalAPI)
 class UInteractiveActor : public UInterface
@@ -53,6 +59,19 @@ public:
 	UFUNCTION(BlueprintNativeEvent)
 	void OnStopInteraction(UInteractiveBoxComponent* InteractiveComponent, APawn* Interactor);
 
+	/**
+	* [all] Fires when the interactor held the interaction for UInteractiveBoxComponent::HoldDuration seconds, after OnInteractionSucceeded.
+	* OnStopInteraction still fires when the interactor releases.
+	*/
+	UFUNCTION(BlueprintNativeEvent)
+	void OnInteractionHoldCompleted(UInteractiveBoxComponent* InteractiveComponent, APawn* Interactor);
+
+	/**
+	* [all] Fires when the interaction stops before UInteractiveBoxComponent::HoldDuration elapsed, right before OnStopInteraction.
+	*/
+	UFUNCTION(BlueprintNativeEvent)
+	void OnInteractionHoldCanceled(UInteractiveBoxComponent* InteractiveComponent, APawn* Interactor);
+
 	/**
 	* [local] See IInteractive::OnFocusReceived
 	*/
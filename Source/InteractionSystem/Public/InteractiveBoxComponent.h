@@ -4,13 +4,28 @@
 
 #include "CoreMinimal.h"
 #include "Components/BoxComponent.h"
+#include "Engine/NetSerialization.h"
 #include "Interactive.h"
+#include "InteractiveDispatch.h"
+#include "InteractionTimerWheel.h"
 #include "InteractiveBoxComponent.generated.h"
 
 class APawn;
+class UInteractiveBoxComponent;
 
+/**
+* Interaction event data, with a custom NetSerialize that packs it into the fewest bits:
+* 1 bit interactor flag, the interactor NetGUID (only if there's a valid interactor), 2 bits for succeeded/denied/stopped/hold completed state, 8 bits sequence,
+* 1 bit prediction flag and 8 bits prediction key (only for events caused by a predicted command),
+* 1 bit instance flag and the packed instance index (only for events of an instanced interactive, see UInteractiveInstancedBoxComponent).
+* So an event is 13 bits plus the interactor NetGUID (the InteractionSystem.Net.NetSerializeRoundTrip automation test checks the 13 bits),
+* 8 more bits when predicted, and 1 to 5 bytes of packed instance index when instanced.
+* Measured by that test with a 1 byte NetGUID, a succeeded event is 21 bits (13 without interactor), where the generic struct layout of the same
+* properties is 60 bits (every property in turn, the int32 instance alone is 32). The layout before this NetSerialize was 10 bits, but it only
+* had the interactor and 2 flags: the sequence, prediction key and instance added since cost 11 bits packed instead of 50.
+*/
 USTRUCT()
-struct FInteractionData
+struct INTERACTIONSYSTEM_API FInteractionData
 {
 	GENERATED_USTRUCT_BODY()
 
@@ -18,8 +33,6 @@ public:
 
 	FInteractionData();
 
-	void EnsureReplication();
-
 	UPROPERTY()
 	TWeakObjectPtr<class APawn> Interactor;
 
@@ -29,20 +42,213 @@ public:
 	UPROPERTY()
 	uint32 bStopInteraction : 1;
 
+	/**
+	* the interactor held the interaction for UInteractiveBoxComponent::HoldDuration
+	*/
+	UPROPERTY()
+	uint32 bHoldCompleted : 1;
+
+	/**
+	* wrapping event counter, assigned by server
+	*/
+	UPROPERTY()
+	uint8 Sequence;
+
+	/**
+	* true if the event was caused by a client command, which the client may have predicted (see UInteractiveBoxComponent::bPredictInteraction)
+	*/
+	UPROPERTY()
+	uint32 bHasPredictionKey : 1;
+
+	/**
+	* sequence of the client command that caused the event, see FScopedInteractionPredictionKey
+	*/
+	UPROPERTY()
+	uint8 PredictionKey;
+
+	/**
+	* instance the event is about, INDEX_NONE if the interactive is not instanced
+	*/
+	UPROPERTY()
+	int32 Instance;
+
+	/**
+	* is this event more recent than the one with OtherSequence, wrap around included?
+	*/
+	FORCEINLINE bool IsNewerThan(uint8 OtherSequence) const { return (int8)(Sequence - OtherSequence) > 0; }
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FInteractionData> : public TStructOpsTypeTraitsBase2<FInteractionData>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+/**
+* [server] prediction key of the client command being processed, events added within this scope carry it (see FInteractionData::PredictionKey).
+* Scopes can be nested, game thread only.
+*/
+struct INTERACTIONSYSTEM_API FScopedInteractionPredictionKey
+{
+	explicit FScopedInteractionPredictionKey(uint8 InPredictionKey);
+	~FScopedInteractionPredictionKey();
+
+	/**
+	* get the key of the innermost scope, false if there's no scope
+	*/
+	static bool GetCurrent(uint8& OutPredictionKey);
+
+private:
+
+	bool bPreviousValid;
+	uint8 PreviousKey;
+
+	static bool bCurrentValid;
+	static uint8 CurrentKey;
+};
+
+/**
+* [client] called with each new event received from server, in the order they were added
+*/
+DECLARE_DELEGATE_OneParam(FOnInteractionEventReceived, const FInteractionData& /*Event*/);
+
+/**
+* [client] locally fired interaction, waiting for the server event with the same prediction key
+*/
+struct FInteractionPrediction
+{
+	TWeakObjectPtr<APawn> Interactor;
+	float Time;
+	uint8 PredictionKey;
+	bool bCanInteract;
+};
+
+/**
+* Replicated interaction event, see FInteractionEventArray
+*/
+USTRUCT()
+struct FInteractionEvent : public FFastArraySerializerItem
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	FInteractionEvent();
+
+	UPROPERTY()
+	FInteractionData Data;
+
+	/**
+	* [server] world time the event was added, used for expiration
+	*/
 	UPROPERTY(NotReplicated)
-	uint32 bFromRep : 1;
+	float Time;
+
+	void PostReplicatedAdd(const struct FInteractionEventArray& InArraySerializer);
+};
+
+/**
+* Bounded queue of the latest interaction events, delta serialized so that only new events are sent to clients.
+* Unlike a single replicated slot, events that happen within the same net update (e.g. interact and stop, or two players interacting) 
+* are not lost, and they are replayed on clients in the same order as on server.
+* Events expire after EventLifetime seconds (the owning component removes them on a timer), and no more than MaxEvents are kept, so the array stays small.
+*
+* Clients don't replay the events of the first state they receive (joining in progress, or the component becoming relevant), they happened before.
+* A resent event (e.g. after packet loss) can be received after newer ones: those wait for it, in sequence order, for MaxReorderDelay seconds at most.
+*/
+USTRUCT()
+struct FInteractionEventArray : public FFastArraySerializer
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	FInteractionEventArray();
+
+	static constexpr int32 MaxEvents = 8;
+	static constexpr float EventLifetime = 2.f;
+	static constexpr float MaxReorderDelay = 1.f;
+
+	/**
+	* [server] add an event and mark it for replication, expired events are removed
+	*/
+	void AddEvent(const FInteractionData& Data, float Time);
+
+	/**
+	* [server] remove the events older than EventLifetime, return true if any was removed
+	*/
+	bool RemoveExpiredEvents(float Time);
+
+	/**
+	* [server] get the time the oldest event expires, false if there's no event
+	*/
+	bool GetNextExpirationTime(float& OutTime) const;
+
+	/**
+	* [client] are received events waiting for an older one? see FlushPendingEvents
+	*/
+	bool HasPendingEvents() const { return PendingEvents.Num() > 0; }
+
+	/**
+	* [client] stop waiting for the missing events (e.g. they expired on server before being sent again), and deliver the pending ones in order
+	*/
+	void FlushPendingEvents();
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms);
 
 private:
 
+	friend struct FInteractionEvent;
+	friend class UInteractiveBoxComponent;
+	friend class UInteractiveInstancedBoxComponent;
+
 	UPROPERTY()
-	uint8 EnsureReplicationByte;
+	TArray<FInteractionEvent> Events;
+
+	// bound by the owning component in PostInitProperties, after the properties were copied from the archetype (and its binding with them)
+	FOnInteractionEventReceived OnEventReceived;
+
+	// [server] see FInteractionData::Sequence
+	uint8 NextSequence;
+
+	// [client] events received after a gap in the sequence, sorted by sequence
+	TArray<FInteractionData> PendingEvents;
+
+	// [client] sequence of the last delivered event
+	uint8 LastReceivedSequence;
+	uint8 bHasReceivedEvent : 1;
+
+	// [client] see NetDeltaSerialize
+	uint8 bReceivedInitialState : 1;
+	uint8 bReceivingInitialState : 1;
 
+	/**
+	* [client] deliver the event if it's the next one, or keep it until the older ones came
+	*/
+	void ReceiveEvent(const FInteractionData& Data);
+
+	void DeliverEvent(const FInteractionData& Data);
+};
+
+template<>
+struct TStructOpsTypeTraits<FInteractionEventArray> : public TStructOpsTypeTraitsBase2<FInteractionEventArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
 };
 
 /**
 * BoxComponent-based implementation of IInteractive interface, with built-in replication.
 * If you're going to add this component or a subclass of this component in your custom actor, you'll likely want to implement the IInteractiveActor interface in that actor. 
-* You must set the actor to replicate, and it should always be relevant (optional steps, if you need to handle replication).
+* You must set the actor to replicate (optional step, if you need to handle replication). You don't need to set it always relevant,
+* the interaction replication graph makes it relevant to players within a configurable radius (see UInteractionReplicationGraph).
 *
 * A general tip about replication. You shouldn't handle things that require some control on synchronization over time, like a moving mesh, 
 * through the replicated events of this component, but you should replicate such things in a different way (see mover timeline in BP_Mover),
@@ -56,13 +262,102 @@ class INTERACTIONSYSTEM_API UInteractiveBoxComponent : public UBoxComponent, pub
 {
 	GENERATED_BODY()
 
+	friend class AInteractiveLevelIndex;
+
 public:
 	UInteractiveBoxComponent(const FObjectInitializer& ObjectInitializer);
 
 	//~ Begin UObject Interface
+	virtual void PostInitProperties() override;
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 	//~ End UObject Interface
 
+	//~ Begin UActorComponent Interface
+	virtual void BeginPlay() override;
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+	virtual bool ShouldCreatePhysicsState() const override;
+	//~ End UActorComponent Interface
+
+	//~ Begin USceneComponent Interface
+	virtual void OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport = ETeleportType::None) override;
+	//~ End USceneComponent Interface
+
+protected:
+
+	/**
+	* The component doesn't tick by default. If this is true, the component ticks only while an interaction is active,
+	* that is from a succeeded OnInteract to OnStopInteraction.
+	* Blueprint subclasses can then use the Tick event to handle it. For press and hold, prefer HoldDuration, which doesn't tick at all.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = InteractionSystem)
+	bool bTickWhileInteracting;
+
+	/**
+	* If this is true, a remote player's interaction is predicted: OnInteract (and so IInteractiveActor::OnInteractionSucceeded/Denied) fires 
+	* on the owning client as soon as the player presses the key, using the replicated state to evaluate CanInteract.
+	* The server event then confirms the prediction, and it's not fired twice, or rolls it back by firing the server outcome (e.g. a denied event).
+	* If nothing comes from server within PredictionTimeout (e.g. someone else is using it), a predicted success is rolled back with a denied event.
+	* Only use this if CanInteract gives the same result on client and server, and if the predicted events are cosmetic or can be undone.
+	* See IsPredictedInteraction
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = InteractionSystem)
+	bool bPredictInteraction;
+
+	/**
+	* seconds to wait for the server event before rolling back a prediction
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = InteractionSystem, meta = (EditCondition = "bPredictInteraction", ClampMin = "0.1"))
+	float PredictionTimeout;
+
+	/**
+	* Added to the focus score in cone focus mode (see UInteractionFocusComponent::FocusMode), so that a higher priority wins among close candidates.
+	* The angle score ranges from 0 to 1, so 1 is a lot.
+	*/
+	UPROPERTY(EditAnywhere, Category = InteractionSystem)
+	float FocusPriority;
+
+	/**
+	* Optional group, so that every interactive of the group can be disabled at once (see UInteractionSubsystem::SetInteractionGroupDisabled).
+	* A disabled group overrides both bInteractionDisabled and the actor implementation.
+	*/
+	UPROPERTY(EditAnywhere, Category = InteractionSystem)
+	FName InteractionGroup;
+
+	/**
+	* If greater than 0, a succeeded interaction must be held for that many seconds: IInteractiveActor::OnInteractionHoldCompleted fires then,
+	* or IInteractiveActor::OnInteractionHoldCanceled if the interaction stops before. The hold is timed on server by the timer wheel
+	* of UInteractionSubsystem, nothing ticks meanwhile, and only its start time is replicated (see GetHoldProgress).
+	*/
+	UPROPERTY(EditAnywhere, Category = InteractionSystem, meta = (ClampMin = "0.0"))
+	float HoldDuration;
+
+	/**
+	* If this is true, the owner is net dormant (DORM_DormantAll) while nothing happens to this component: interaction events,
+	* availability and hold changes wake it up, and it goes dormant again after NetDormancyQuietPeriod seconds without any.
+	* Idle interactives then cost nothing to the server replication. Only use this if the owner doesn't replicate any other changing state,
+	* or if it wakes up itself when that state changes (see AActor::FlushNetDormancy). Owners set to DORM_Never are left alone.
+	* Note that state the owner keeps changing after an interaction stops replicating once NetDormancyQuietPeriod passes,
+	* e.g. a platform that BP_Mover keeps moving after OnInteractionSucceeded: make the quiet period longer than that, or flush dormancy from the owner.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = InteractionSystem)
+	bool bManageOwnerNetDormancy;
+
+	/**
+	* seconds without activity before the owner goes dormant again
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = InteractionSystem, meta = (EditCondition = "bManageOwnerNetDormancy", ClampMin = "0.1"))
+	float NetDormancyQuietPeriod;
+
+	/**
+	* With the actor implementation, changes of IInteractiveActor::IsInteractionDisabled and GetMessage are detected after each interaction event,
+	* and again when the owner timelines playing then end (see RefreshActorInteractionState), e.g. BP_LockedDoor and BP_Mover.
+	* Set this if the owner changes them some other way without calling NotifyInteractionAvailabilityChanged or NotifyInteractionStateChanged,
+	* so that the focus component polls them as a fallback (see UInteractionFocusComponent::InteractionStatePollInterval).
+	*/
+	UPROPERTY(EditAnywhere, Category = InteractionSystem)
+	bool bPollActorInteractionState;
+
 private:
 	// let the interactive component to be used by one pawn only at a time, property used on server only
 	TWeakObjectPtr<APawn> CurrentInteractor;
@@ -70,24 +365,190 @@ private:
 	/**
 	* See SetInteractionDisabled
 	*/
-	UPROPERTY(EditAnywhere, Replicated)
+	UPROPERTY(EditAnywhere, ReplicatedUsing=OnRep_InteractionDisabled)
 	bool bInteractionDisabled;
 
-	UPROPERTY(ReplicatedUsing=OnRep_LastInteraction)
-	FInteractionData LastInteraction;
+	FOnInteractionAvailabilityChanged OnInteractionAvailabilityChanged;
+
+	FOnInteractionStateChanged OnInteractionStateChanged;
+
+	// cached on register, null outside of game worlds
+	TWeakObjectPtr<class UInteractionSubsystem> InteractionSubsystem;
+
+	/**
+	* set on cook by the AInteractiveLevelIndex of the level, which then adds this to the registry when the level is loaded
+	*/
+	UPROPERTY()
+	bool bRegisteredByLevelIndex;
+
+	/**
+	* true from the level load until the level index adds this to the registry, no physics state is created meanwhile (see OnAddedByLevelIndex)
+	*/
+	bool bPendingLevelIndex;
+
+	// see GetInteractionGroupIndex
+	mutable int32 InteractionGroupIndex;
+
+	UPROPERTY(ReplicatedUsing = OnRep_InteractionEvents)
+	FInteractionEventArray InteractionEvents;
+
+	// true while replaying a replicated event, see OnRep_InteractionEvent
+	uint8 bReplayingInteraction : 1;
+
+	// [server] see FInteractionEventArray::EventLifetime
+	FTimerHandle TimerHandle_ExpireInteractionEvents;
+
+	// [client] see FInteractionEventArray::MaxReorderDelay
+	FTimerHandle TimerHandle_FlushInteractionEvents;
+
+	// true while firing a predicted event or its rollback, see IsPredictedInteraction
+	uint8 bPredictingInteraction : 1;
+
+	// [client] predictions waiting for confirmation, oldest first
+	TArray<FInteractionPrediction> PendingPredictions;
+
+	FTimerHandle TimerHandle_PredictionTimeout;
+
+	/**
+	* server world time the current hold started, negative if there's no hold. The only replicated hold state, see GetHoldProgress
+	*/
+	UPROPERTY(ReplicatedUsing = OnRep_HoldStartTime)
+	float HoldStartTime;
+
+	// true from a succeeded OnInteract to the hold completion or cancelation, driven by events so that clients know when to fire the cancelation
+	uint8 bHolding : 1;
+
+	// [server] see HoldDuration
+	FInteractionTimerHandle HoldTimerHandle;
+
+	/**
+	* [all] start the hold of a succeeded interaction, timed on server only
+	*/
+	void BeginHold(bool bFromReplication);
+
+	/**
+	* [all] the hold is over, completed or canceled
+	*/
+	void EndHold(bool bFromReplication);
+
+	/**
+	* [server] the timer wheel fired, the interactor held long enough
+	*/
+	void OnHoldTimerExpired();
+
+	/**
+	* [all] fire the hold completion, and on server add its event
+	*/
+	void CompleteHold(APawn* Interactor);
+
+	UFUNCTION()
+	void OnRep_HoldStartTime();
+
+	/**
+	* [client] fire OnInteract locally, as if the event came from server
+	*/
+	void PlayPredictedInteraction(APawn* Interactor, bool bCanInteract);
+
+	/**
+	* [client] match a server event with a pending prediction, return true if it was predicted correctly and shouldn't be replayed
+	*/
+	bool ReconcilePrediction(const FInteractionData& Event);
+
+	/**
+	* [client] roll back predictions that got no server event in time
+	*/
+	void OnPredictionTimeout();
+
+	// interface resolution of this class and of the owner class, see CacheInteractiveInfo
+	FInteractiveClassInfo ClassInfo;
+	FInteractiveClassInfo OwnerClassInfo;
+
+	uint8 bOwnerInteractive : 1;
+	uint8 bUseActorImplementation : 1;
+
+	// see ShouldPollInteractionState
+	uint8 bPollInteractionState : 1;
+
+	// [local + server] IInteractiveActor::IsInteractionDisabled when it was last evaluated, see RefreshActorInteractionState
+	uint8 bActorInteractionDisabled : 1;
+
+	FTimerHandle TimerHandle_RefreshActorInteractionState;
+
+	/**
+	* [all] with the actor implementation, evaluate the actor state again on the next tick: the owner reacts to the event meanwhile
+	* (e.g. starts a timeline), and on clients its replicated state may be received after the event
+	*/
+	void ScheduleActorInteractionStateRefresh(float Delay = KINDA_SMALL_NUMBER);
+
+	/**
+	* [all] broadcast the availability of the actor implementation if it changed, or else a state change for the message,
+	* then schedule another refresh when the first of the owner timelines playing ends
+	*/
+	void RefreshActorInteractionState();
+
+	/**
+	* resolve the class infos and the owner flags once, on register
+	*/
+	void CacheInteractiveInfo();
 
 	/**
 	* does owner implement IInteractiveActor interface?
 	*/
-	bool IsOwnerInteractive() const;
+	bool IsOwnerInteractive() const { return bOwnerInteractive; }
 
 	/**
 	* does owner implement IInteractiveActor interface, and IInteractiveActor::ShouldUseActorImplementation return true?
 	*/
-	bool ShouldUseActorImplementation() const;
+	bool ShouldUseActorImplementation() const { return bUseActorImplementation; }
+
+	/**
+	* register for tick (or unregister) on demand, see bTickWhileInteracting
+	*/
+	void SetInteractionTickEnabled(bool bEnabled);
+
+	/**
+	* [server] make sure state changes reach players in range on the next net update
+	*/
+	void ForceOwnerNetUpdate();
+
+	// [server] quiet period before the owner goes dormant again, see bManageOwnerNetDormancy
+	FInteractionTimerHandle NetDormancyTimerHandle;
+
+	/**
+	* [server] wake the owner up, and restart the quiet period
+	*/
+	void WakeOwnerNetDormancy();
+
+	/**
+	* [server] the quiet period elapsed, let the owner go dormant unless another interactive of the owner is still awake
+	*/
+	void OnNetDormancyQuietPeriodExpired();
+
+	/**
+	* [server] add an event, mark it for replication and schedule its expiration
+	*/
+	void AddInteractionEvent(const FInteractionData& Event);
+
+	/**
+	* [server] remove the expired events, and wait for the next one to expire
+	*/
+	void ExpireInteractionEvents();
+
+	/**
+	* [client] events were received, give the ones waiting for a missing event MaxReorderDelay
+	*/
+	UFUNCTION()
+	void OnRep_InteractionEvents();
+
+	/**
+	* [client] the missing events didn't come in time, see FInteractionEventArray::FlushPendingEvents
+	*/
+	void FlushInteractionEvents();
+
+	friend struct FInteractionEvent;
 
 	UFUNCTION()
-	void OnRep_LastInteraction();
+	void OnRep_InteractionDisabled();
 
 // ~Begin IInteractive Interface
 
@@ -135,6 +596,15 @@ public:
 	*/
 	virtual bool IsInteractionDisabled_Implementation() const override;
 
+	virtual FOnInteractionAvailabilityChanged* GetOnInteractionAvailabilityChanged() override;
+
+	/**
+	* [local] true if the state is implemented in blueprint (actor implementation or a blueprint override), which may not notify its changes
+	*/
+	virtual bool ShouldPollInteractionState() const override { return bPollInteractionState; }
+
+	virtual FOnInteractionStateChanged* GetOnInteractionStateChanged() override;
+
 // ~End IInteractive Interface
 
 public:
@@ -145,6 +615,68 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void SetInteractionDisabled(bool bDisabled);
 
+	/**
+	* [local + server] Broadcast the current IsInteractionDisabled value to listeners (i.e. the player focusing this component).
+	* Called by SetInteractionDisabled, but you should call this yourself if IInteractiveActor::IsInteractionDisabled is used and the actor state changes
+	* other than from an interaction event or a timeline, otherwise players only notice on the next poll (see bPollActorInteractionState).
+	*/
+	UFUNCTION(BlueprintCallable)
+	void NotifyInteractionAvailabilityChanged();
+
+	/**
+	* [local] Let listeners (i.e. the HUD of the player focusing this component) know the message may have changed.
+	* Called on interaction events and by NotifyInteractionAvailabilityChanged, but you should call this yourself 
+	* if IInteractiveActor::GetMessage is used and depends on some other actor state which changed, otherwise the HUD only updates on the next poll
+	* (see bPollActorInteractionState).
+	*/
+	UFUNCTION(BlueprintCallable)
+	void NotifyInteractionStateChanged();
+
+	/**
+	* [client] Fire the interaction locally for a remote player if bPredictInteraction is true, PredictionKey being the sequence of the command sent to server.
+	* Does nothing if the interaction is disabled, or there's already a predicted or active interaction for that player.
+	*/
+	void PredictInteraction(APawn* Interactor, uint8 PredictionKey);
+
+	/**
+	* [client] True while IInteractiveActor events are fired by a prediction (or by its rollback on timeout) rather than by a server event.
+	*/
+	UFUNCTION(BlueprintCallable)
+	bool IsPredictedInteraction() const;
+
+	/**
+	* [client] Replay an interaction event received from server (see FInteractionEventArray): fires OnInteract or OnStopInteraction,
+	* unless it confirms a prediction.
+	*/
+	void OnRep_InteractionEvent(const FInteractionData& Event);
+
+	/**
+	* [level index] Called by UInteractionSubsystem when it adds this component from the AInteractiveLevelIndex of its level:
+	* creates the physics state deferred on level load, so that it's time-sliced along with the registration.
+	*/
+	void OnAddedByLevelIndex();
+
+	float GetFocusPriority() const { return FocusPriority; }
+
+	/**
+	* [local + server] index of InteractionGroup in the replicated groups table, INDEX_NONE if there's no group or it's not known yet
+	*/
+	int32 GetInteractionGroupIndex() const;
+
+	bool IsInteractionGroupDisabled() const;
+
+	/**
+	* [all] true while a hold is in progress, see HoldDuration
+	*/
+	UFUNCTION(BlueprintCallable)
+	bool IsHolding() const { return HoldStartTime >= 0.f; }
+
+	/**
+	* [all] Progress of the current hold from 0 to 1 (e.g. for a HUD progress bar, to poll while IsHolding), 0 if there's no hold.
+	* Based on the server world time, so it's the same for everyone.
+	*/
+	UFUNCTION(BlueprintCallable)
+	float GetHoldProgress() const;
 
 
 };
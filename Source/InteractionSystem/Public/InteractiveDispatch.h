@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* IInteractive, IInteractiveActor and IInteractiveInstancedActor events, named Interface_Event so they can be used by INTERACTIVE_EXECUTE.
+*/
+enum class EInteractiveEvent : uint8
+{
+	IInteractive_OnInteract,
+	IInteractive_OnStopInteraction,
+	IInteractive_OnFocusReceived,
+	IInteractive_OnFocusLost,
+	IInteractive_CanInteract,
+	IInteractive_GetMessage,
+	IInteractive_IsInteractionDisabled,
+
+	IInteractiveActor_OnInteractionSucceeded,
+	IInteractiveActor_OnInteractionDenied,
+	IInteractiveActor_OnStopInteraction,
+	IInteractiveActor_OnInteractionHoldCompleted,
+	IInteractiveActor_OnInteractionHoldCanceled,
+	IInteractiveActor_OnFocusReceived,
+	IInteractiveActor_OnFocusLost,
+	IInteractiveActor_CanInteract,
+	IInteractiveActor_GetMessage,
+	IInteractiveActor_IsInteractionDisabled,
+	IInteractiveActor_ShouldUseActorImplementation,
+
+	IInteractiveInstancedActor_OnInstanceInteractionSucceeded,
+	IInteractiveInstancedActor_OnInstanceInteractionDenied,
+	IInteractiveInstancedActor_OnInstanceStopInteraction,
+	IInteractiveInstancedActor_OnInstanceFocusReceived,
+	IInteractiveInstancedActor_OnInstanceFocusLost,
+	IInteractiveInstancedActor_CanInteractInstance,
+	IInteractiveInstancedActor_GetInstanceMessage,
+	IInteractiveInstancedActor_IsInstanceInteractionDisabled,
+	IInteractiveInstancedActor_ShouldUseInstancedActorImplementation,
+
+	Count
+};
+
+/**
+* Per-class cache of the interactive interfaces resolution, built the first time a class is queried,
+* and thrown away when blueprints are compiled or reinstanced in editor (classes are kept, their functions are not) and when classes are garbage collected.
+* It tells whether the class implements IInteractive / IInteractiveActor (and their instanced counterparts), and which of their events are actually overridden in blueprint.
+* Events that are implemented natively and not overridden in blueprint don't need to go through ProcessEvent,
+* so they can call the _Implementation function directly (see INTERACTIVE_EXECUTE).
+* Game thread only.
+*/
+struct INTERACTIONSYSTEM_API FInteractiveClassInfo
+{
+	FInteractiveClassInfo();
+
+	uint32 bImplementsInteractive : 1;
+	uint32 bImplementsInteractiveActor : 1;
+	uint32 bImplementsInteractiveInstanced : 1;
+	uint32 bImplementsInteractiveInstancedActor : 1;
+
+	/**
+	* can Event skip the blueprint VM, i.e. the interface is implemented in C++ and the event is not overridden in blueprint?
+	*/
+	bool CanCallNative(EInteractiveEvent Event) const;
+
+	/**
+	* a copy, the cache may be rebuilt at any time
+	*/
+	static FInteractiveClassInfo Get(const UClass* Class);
+
+private:
+
+	uint32 bNativeInteractive : 1;
+	uint32 bNativeInteractiveActor : 1;
+	uint32 bNativeInteractiveInstancedActor : 1;
+
+	// one bit per EInteractiveEvent, set if the event is overridden in blueprint
+	uint32 BlueprintEventMask;
+
+	void Build(const UClass* Class);
+};
+
+/**
+* Same as Interface::Execute_Event(Object, ...), but calls the native implementation directly if the event isn't overridden in blueprint.
+* ClassInfo must be the FInteractiveClassInfo of the Object class, and Object must implement Interface.
+*/
+#define INTERACTIVE_EXECUTE_CACHED(ClassInfo, Interface, Event, Object, ...) \
+	((ClassInfo).CanCallNative(EInteractiveEvent::Interface##_##Event) \
+		? Cast<Interface>(Object)->Event##_Implementation(__VA_ARGS__) \
+		: Interface::Execute_##Event(Object, ##__VA_ARGS__))
+
+#define INTERACTIVE_EXECUTE(Interface, Event, Object, ...) \
+	INTERACTIVE_EXECUTE_CACHED(FInteractiveClassInfo::Get((Object)->GetClass()), Interface, Event, Object, ##__VA_ARGS__)
@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "InteractiveInstanced.generated.h"
+
+class APawn;
+
+/**
+* Same as FOnInteractionAvailabilityChanged, for one instance of an instanced interactive.
+*/
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnInstanceInteractionAvailabilityChanged, UObject* /* Interactive */, int32 /* Instance */, bool /* bDisabled */);
+
+/**
+* Same as FOnInteractionStateChanged, for one instance of an instanced interactive.
+*/
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnInstanceInteractionStateChanged, UObject* /* Interactive */, int32 /* Instance */);
+
+/**
+* Counterpart of IInteractive for a component hosting many interaction volumes (instances), so that hundreds of identical interactives
+* (e.g. the switches of a control room) don't cost a component each. Every event carries the instance index, which is the same on all machines.
+* The player focuses, interacts with and stops interacting with an instance, exactly as with an IInteractive component.
+*
+* This is a native interface: blueprints handle instanced interactions in the owning actor, see IInteractiveInstancedActor.
+* You can find an implementation of this interface in UInteractiveInstancedBoxComponent.
+*
+* See IInteractive
+* See UInteractiveInstancedBoxComponent
+*/
+UINTERFACE(MinimalAPI, meta = (CannotImplementInterfaceInBlueprint))
+class UInteractiveInstanced : public UInterface
+{
+	GENERATED_BODY()
+};
+
+class INTERACTIONSYSTEM_API IInteractiveInstanced
+{
+	GENERATED_BODY()
+
+protected:
+
+	/**
+	* [server] See IInteractive::TryInteract
+	*/
+	virtual void TryInteractInstance(int32 Instance, APawn* Interactor) = 0;
+
+	/**
+	* [server] See IInteractive::OnStopInteraction
+	*/
+	virtual void StopInstanceInteraction(int32 Instance, APawn* Interactor) = 0;
+
+public:
+
+	/**
+	* [server] helper function that calls TryInteractInstance
+	*/
+	static void Interact(UObject* Target, int32 Instance, APawn* Interactor);
+
+	/**
+	* [server] helper function that calls StopInstanceInteraction
+	*/
+	static void StopInteraction(UObject* Target, int32 Instance, APawn* Interactor);
+
+	/**
+	* [all] is Instance an instance of this interactive? Instance indices come from the network, so they are checked before any other call.
+	*/
+	virtual bool IsValidInstance(int32 Instance) const = 0;
+
+	/**
+	* [local] See IInteractive::OnFocusReceived
+	*/
+	virtual void OnInstanceFocusReceived(int32 Instance, APawn* Interactor) = 0;
+
+	/**
+	* [local] See IInteractive::OnFocusLost
+	*/
+	virtual void OnInstanceFocusLost(int32 Instance, APawn* Interactor) = 0;
+
+	/**
+	* [server] See IInteractive::CanInteract
+	*/
+	virtual bool CanInteractInstance(int32 Instance, const APawn* Interactor) const = 0;
+
+	/**
+	* [local] See IInteractive::GetMessage
+	*/
+	virtual FText GetInstanceMessage(int32 Instance, const APawn* Interactor) const = 0;
+
+	/**
+	* [local + server] See IInteractive::IsInteractionDisabled
+	*/
+	virtual bool IsInstanceInteractionDisabled(int32 Instance) const = 0;
+
+	/**
+	* [local + server] See IInteractive::GetOnInteractionAvailabilityChanged
+	*/
+	virtual FOnInstanceInteractionAvailabilityChanged* GetOnInstanceInteractionAvailabilityChanged() { return nullptr; }
+
+	/**
+	* [local] See IInteractive::ShouldPollInteractionState
+	*/
+	virtual bool ShouldPollInstanceState() const { return true; }
+
+	/**
+	* [local] See IInteractive::GetOnInteractionStateChanged
+	*/
+	virtual FOnInstanceInteractionStateChanged* GetOnInstanceInteractionStateChanged() { return nullptr; }
+};
@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "InteractiveInstancedActor.generated.h"
+
+class UInteractiveInstancedBoxComponent;
+class APawn;
+
+/**
+* Counterpart of IInteractiveActor for actors with instanced interactive components (see UInteractiveInstancedBoxComponent):
+* the same events and validation functions, with the index of the instance. An actor can implement both interfaces.
+* As with IInteractiveActor, the validation functions (CanInteractInstance, GetInstanceMessage, IsInstanceInteractionDisabled) are only used
+* if ShouldUseInstancedActorImplementation returns true, and they must not call the component counterparts.
+* When the actor implementation is used, the actor must call UInteractiveInstancedBoxComponent::NotifyInstanceAvailabilityChanged
+* and NotifyInstanceStateChanged whenever the state they depend on changes, nothing is polled.
+*/
+UINTERFACE(MinimalAPI)
+class UInteractiveInstancedActor : public UInterface
+{
+	GENERATED_BODY()
+};
+
+class INTERACTIONSYSTEM_API IInteractiveInstancedActor
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	* [all] See IInteractiveActor::OnInteractionSucceeded
+	*/
+	UFUNCTION(BlueprintNativeEvent)
+	void OnInstanceInteractionSucceeded(UInteractiveInstancedBoxComponent* InteractiveComponent, int32 Instance, APawn* Interactor);
+
+	/**
+	* [all] See IInteractiveActor::OnInteractionDenied
+	*/
+	UFUNCTION(BlueprintNativeEvent)
+	void OnInstanceInteractionDenied(UInteractiveInstancedBoxComponent* InteractiveComponent, int32 Instance, APawn* Interactor);
+
+	/**
+	* [all] See IInteractiveActor::OnStopInteraction
+	*/
+	UFUNCTION(BlueprintNativeEvent)
+	void OnInstanceStopInteraction(UInteractiveInstancedBoxComponent* InteractiveComponent, int32 Instance, APawn* Interactor);
+
+	/**
+	* [local] See IInteractiveActor::OnFocusReceived
+	*/
+	UFUNCTION(BlueprintNativeEvent)
+	void OnInstanceFocusReceived(UInteractiveInstancedBoxComponent* InteractiveComponent, int32 Instance, APawn* Interactor);
+
+	/**
+	* [local] See IInteractiveActor::OnFocusLost
+	*/
+	UFUNCTION(BlueprintNativeEvent)
+	void OnInstanceFocusLost(UInteractiveInstancedBoxComponent* InteractiveComponent, int32 Instance, APawn* Interactor);
+
+	/**
+	* [server] See IInteractiveActor::CanInteract
+	*/
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable)
+	bool CanInteractInstance(const UInteractiveInstancedBoxComponent* InteractiveComponent, int32 Instance, const APawn* Interactor) const;
+
+	/**
+	* [local] See IInteractiveActor::GetMessage
+	*/
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable)
+	FText GetInstanceMessage(const UInteractiveInstancedBoxComponent* InteractiveComponent, int32 Instance, const APawn* Interactor) const;
+
+	/**
+	* [local + server] See IInteractiveActor::IsInteractionDisabled
+	*/
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable)
+	bool IsInstanceInteractionDisabled(const UInteractiveInstancedBoxComponent* InteractiveComponent, int32 Instance) const;
+
+	/**
+	* [server] See IInteractiveActor::ShouldUseActorImplementation
+	*/
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable)
+	bool ShouldUseInstancedActorImplementation() const;
+
+};
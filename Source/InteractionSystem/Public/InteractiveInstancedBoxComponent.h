@@ -0,0 +1,360 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/PrimitiveComponent.h"
+#include "InteractiveInstanced.h"
+#include "InteractiveDispatch.h"
+#include "InteractiveBoxComponent.h"
+#include "InteractiveInstancedBoxComponent.generated.h"
+
+class APawn;
+class UBodySetup;
+
+/**
+* Replicated interactor of an instance in use, see FInteractiveInstanceUseArray
+*/
+USTRUCT()
+struct FInteractiveInstanceUse : public FFastArraySerializerItem
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	FInteractiveInstanceUse();
+
+	UPROPERTY()
+	int32 Instance;
+
+	UPROPERTY()
+	APawn* Interactor;
+};
+
+/**
+* The instances in use and their interactor, delta serialized so that only the instances which started or stopped being used are sent.
+* Interaction events tell clients what happened, this tells them the resulting state: an event dropped from the shared queue (see FInteractionEventArray::MaxEvents)
+* or received before the component (joining in progress) doesn't leave an instance in use or free on a client.
+*/
+USTRUCT()
+struct FInteractiveInstanceUseArray : public FFastArraySerializer
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	/**
+	* [server] set the interactor of the instance and mark it for replication, null when the instance is not in use anymore
+	*/
+	void SetInteractor(int32 Instance, APawn* Interactor);
+
+	/**
+	* [all] interactor of the instance, null if it's not in use
+	*/
+	APawn* GetInteractor(int32 Instance) const;
+
+	const TArray<FInteractiveInstanceUse>& GetUses() const { return Uses; }
+
+	void Reset();
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FInteractiveInstanceUse, FInteractiveInstanceUseArray>(Uses, DeltaParms, *this);
+	}
+
+private:
+
+	UPROPERTY()
+	TArray<FInteractiveInstanceUse> Uses;
+};
+
+template<>
+struct TStructOpsTypeTraits<FInteractiveInstanceUseArray> : public TStructOpsTypeTraitsBase2<FInteractiveInstanceUseArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/**
+* Many box interaction volumes (instances) in a single component, in the spirit of instanced static meshes, e.g. the 500 switches of a control room.
+* Each instance is a box of BoxExtent at its own transform relative to the component, with its own physics body blocking the "Interactive" trace channel
+* (one body per instance, as instanced static meshes do), so the focus trace hit tells the instance (FHitResult::Item).
+*
+* Per-instance state is kept in flat arrays rather than UObjects: the disabled state is a replicated bitset (32 instances per word),
+* the interactors of the instances in use are a map, and all instances share one replicated event queue whose events carry the instance index
+* (see FInteractionEventArray, its MaxEvents limit applies to the whole component, as does the interactive rate limit of UInteractionSubsystem).
+* A burst of events on many instances can overflow the queue, so the instances in use are replicated as well (see FInteractiveInstanceUseArray):
+* clients may miss some events, but not the resulting state. So memory, registration and replication scale
+* with the instance data and with the instances in use, not with the number of interactives.
+*
+* Instances are part of the component data (details panel, or AddInstance from the construction script), and they must not change once play begun:
+* their indices are what the network refers to.
+* Compared to UInteractiveBoxComponent there's no prediction, no press and hold, no tick, no interaction group and no net dormancy management,
+* and instances are not in the UInteractionSubsystem registry, so the Trace focus mode only finds them.
+*
+* See IInteractiveInstanced
+* See IInteractiveInstancedActor
+*/
+UCLASS(ClassGroup = InteractionSystem, meta = (BlueprintSpawnableComponent))
+class INTERACTIONSYSTEM_API UInteractiveInstancedBoxComponent : public UPrimitiveComponent, public IInteractiveInstanced
+{
+	GENERATED_BODY()
+
+public:
+	UInteractiveInstancedBoxComponent(const FObjectInitializer& ObjectInitializer);
+
+	//~ Begin UObject Interface
+	virtual void PostInitProperties() override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	//~ End UObject Interface
+
+	//~ Begin UActorComponent Interface
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+	//~ End UActorComponent Interface
+
+	//~ Begin USceneComponent Interface
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+	//~ End USceneComponent Interface
+
+	//~ Begin UPrimitiveComponent Interface
+	virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+	virtual UBodySetup* GetBodySetup() override;
+	virtual bool CanEditSimulatePhysics() override { return false; }
+	//~ End UPrimitiveComponent Interface
+
+protected:
+
+	//~ Begin UActorComponent Interface
+	virtual void OnCreatePhysicsState() override;
+	virtual void OnDestroyPhysicsState() override;
+	//~ End UActorComponent Interface
+
+	//~ Begin USceneComponent Interface
+	virtual void OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport = ETeleportType::None) override;
+	//~ End USceneComponent Interface
+
+	/**
+	* half size of every instance box, before the instance scale
+	*/
+	UPROPERTY(EditAnywhere, Category = InteractionSystem)
+	FVector BoxExtent;
+
+	/**
+	* transforms of the instances relative to the component, the index of an instance is its index in this array
+	*/
+	UPROPERTY(EditAnywhere, Category = InteractionSystem)
+	TArray<FTransform> InstanceTransforms;
+
+private:
+
+	friend class FInteractiveInstancedBoxSceneProxy;
+
+	// [all] interactor of each instance in use, one pawn at a time per instance
+	TMap<int32, TWeakObjectPtr<APawn>> CurrentInteractors;
+
+	/**
+	* a bit per instance, see SetInstanceInteractionDisabled
+	*/
+	UPROPERTY(ReplicatedUsing = OnRep_DisabledInstanceBits)
+	TArray<uint32> DisabledInstanceBits;
+
+	/**
+	* CurrentInteractors as set by server, see ReconcileInstanceUses
+	*/
+	UPROPERTY(ReplicatedUsing = OnRep_InstanceUses)
+	FInteractiveInstanceUseArray InstanceUses;
+
+	UPROPERTY(ReplicatedUsing = OnRep_InteractionEvents)
+	FInteractionEventArray InteractionEvents;
+
+	// true while replaying a replicated event, see OnRep_InteractionEvent
+	uint8 bReplayingInteraction : 1;
+
+	// [server] see FInteractionEventArray::EventLifetime
+	FTimerHandle TimerHandle_ExpireInteractionEvents;
+
+	// [client] see FInteractionEventArray::MaxReorderDelay
+	FTimerHandle TimerHandle_FlushInteractionEvents;
+
+	FOnInstanceInteractionAvailabilityChanged OnInstanceInteractionAvailabilityChanged;
+
+	FOnInstanceInteractionStateChanged OnInstanceInteractionStateChanged;
+
+	// interface resolution of the owner class, see CacheInteractiveInfo
+	FInteractiveClassInfo OwnerClassInfo;
+
+	uint8 bOwnerInteractive : 1;
+	uint8 bUseActorImplementation : 1;
+
+	/**
+	* resolve the owner class info and flags once, on register
+	*/
+	void CacheInteractiveInfo();
+
+	// one body per instance, null for instances with a zero scale
+	TArray<FBodyInstance*> InstanceBodies;
+
+	// a single box, shared by all instance bodies
+	UPROPERTY(Transient, DuplicateTransient)
+	UBodySetup* InstanceBodySetup;
+
+	/**
+	* create the bodies of the instances from FirstInstance on, the ones before already have theirs
+	*/
+	void CreateInstanceBodies(int32 FirstInstance);
+
+	void DestroyInstanceBodies();
+
+	/**
+	* [all] start the interaction with an instance, or replay it from a server event
+	*/
+	void InteractInstance(int32 Instance, APawn* Interactor, bool bCanInteract);
+
+	/**
+	* [server] add an event for the instance, mark it for replication and schedule its expiration
+	*/
+	void AddInteractionEvent(const FInteractionData& Event);
+
+	/**
+	* [server] remove the expired events, and wait for the next one to expire
+	*/
+	void ExpireInteractionEvents();
+
+	/**
+	* [server] make sure state changes reach players in range on the next net update
+	*/
+	void ForceOwnerNetUpdate();
+
+	/**
+	* [client] replay an interaction event received from server, see FInteractionEventArray
+	*/
+	void OnRep_InteractionEvent(const FInteractionData& Event);
+
+	/**
+	* [client] events were received, give the ones waiting for a missing event MaxReorderDelay
+	*/
+	UFUNCTION()
+	void OnRep_InteractionEvents();
+
+	/**
+	* [client] the missing events didn't come in time, see FInteractionEventArray::FlushPendingEvents
+	*/
+	void FlushInteractionEvents();
+
+	UFUNCTION()
+	void OnRep_InstanceUses();
+
+	/**
+	* [client] Make CurrentInteractors match the replicated InstanceUses once events were replayed:
+	* interactions the server stopped are stopped (their stop event was lost), instances in use without an interact event are set in use silently.
+	*/
+	void ReconcileInstanceUses();
+
+	UFUNCTION()
+	void OnRep_DisabledInstanceBits(const TArray<uint32>& OldDisabledInstanceBits);
+
+	bool IsInstanceDisabledBitSet(int32 Instance) const
+	{
+		const int32 Word = Instance >> 5;
+		return Instance >= 0 && Word < DisabledInstanceBits.Num() && (DisabledInstanceBits[Word] & (1u << (Instance & 31))) != 0;
+	}
+
+// ~Begin IInteractiveInstanced Interface
+
+protected:
+
+	/**
+	* [server]
+	*/
+	virtual void TryInteractInstance(int32 Instance, APawn* Interactor) override;
+
+	/**
+	* [all]
+	*/
+	virtual void StopInstanceInteraction(int32 Instance, APawn* Interactor) override;
+
+public:
+
+	virtual bool IsValidInstance(int32 Instance) const override { return InstanceTransforms.IsValidIndex(Instance); }
+
+	/**
+	* [local]
+	*/
+	virtual void OnInstanceFocusReceived(int32 Instance, APawn* Interactor) override;
+
+	/**
+	* [local]
+	*/
+	virtual void OnInstanceFocusLost(int32 Instance, APawn* Interactor) override;
+
+	/**
+	* [server]
+	*/
+	virtual bool CanInteractInstance(int32 Instance, const APawn* Interactor) const override;
+
+	/**
+	* [local]
+	*/
+	virtual FText GetInstanceMessage(int32 Instance, const APawn* Interactor) const override;
+
+	/**
+	* [local + server]
+	*/
+	virtual bool IsInstanceInteractionDisabled(int32 Instance) const override;
+
+	virtual FOnInstanceInteractionAvailabilityChanged* GetOnInstanceInteractionAvailabilityChanged() override;
+
+	/**
+	* [local] true with the actor implementation, which may not notify its changes
+	*/
+	virtual bool ShouldPollInstanceState() const override { return bUseActorImplementation; }
+
+	virtual FOnInstanceInteractionStateChanged* GetOnInstanceInteractionStateChanged() override;
+
+// ~End IInteractiveInstanced Interface
+
+public:
+
+	/**
+	* Add an instance, and get its index. Construction script only, instances must be the same on all machines and must not change once play begun.
+	*/
+	UFUNCTION(BlueprintCallable)
+	int32 AddInstance(const FTransform& InstanceTransform);
+
+	UFUNCTION(BlueprintCallable)
+	int32 GetInstanceCount() const { return InstanceTransforms.Num(); }
+
+	/**
+	* transform of the instance box, relative to the component or in world space, identity if Instance is not valid
+	*/
+	UFUNCTION(BlueprintCallable)
+	FTransform GetInstanceTransform(int32 Instance, bool bWorldSpace) const;
+
+	/**
+	* [server] Enable or disable an instance, a single bit to replicate.
+	*/
+	UFUNCTION(BlueprintCallable)
+	void SetInstanceInteractionDisabled(int32 Instance, bool bDisabled);
+
+	/**
+	* [local + server] Broadcast the current IsInstanceInteractionDisabled value of the instance to listeners, see UInteractiveBoxComponent::NotifyInteractionAvailabilityChanged.
+	*/
+	UFUNCTION(BlueprintCallable)
+	void NotifyInstanceAvailabilityChanged(int32 Instance);
+
+	/**
+	* [local] Let listeners know the message of the instance may have changed, see UInteractiveBoxComponent::NotifyInteractionStateChanged.
+	*/
+	UFUNCTION(BlueprintCallable)
+	void NotifyInstanceStateChanged(int32 Instance);
+
+	/**
+	* [all] interactor of the instance, null if it's not in use
+	*/
+	UFUNCTION(BlueprintCallable)
+	APawn* GetInstanceInteractor(int32 Instance) const;
+
+};
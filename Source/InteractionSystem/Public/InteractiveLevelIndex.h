@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "InteractiveLevelIndex.generated.h"
+
+class UInteractiveBoxComponent;
+
+/**
+* Index of the interactive components of a level, built when the level is cooked. Place one in each level with many interactives (e.g. streamed sublevels).
+* Indexed components skip their own registration with UInteractionSubsystem when the level is loaded, the index adds them instead,
+* LevelIndexEntriesPerFrame at a time (see UInteractionSubsystem), so streaming in thousands of interactives doesn't cause a frame spike.
+* Their physics state is created then too, so they're invisible to the COLLISION_INTERACTIVE traces until added.
+* Not replicated, every machine loads its own copy with the level.
+*/
+UCLASS(hidecategories = (Input, Rendering))
+class INTERACTIONSYSTEM_API AInteractiveLevelIndex : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+
+	AInteractiveLevelIndex();
+
+	//~ Begin UObject Interface
+#if WITH_EDITOR
+	virtual void PreSave(const class ITargetPlatform* TargetPlatform) override;
+#endif
+	//~ End UObject Interface
+
+	//~ Begin AActor Interface
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	//~ End AActor Interface
+
+	const TArray<UInteractiveBoxComponent*>& GetInteractives() const { return Interactives; }
+
+private:
+
+	/**
+	* interactive components of the level, built on cook
+	*/
+	UPROPERTY()
+	TArray<UInteractiveBoxComponent*> Interactives;
+
+#if WITH_EDITOR
+	/**
+	* gather the interactive components of the level and flag them as indexed if bIndex, otherwise empty the index and clear the flags
+	*/
+	void Rebuild(bool bIndex);
+#endif
+};
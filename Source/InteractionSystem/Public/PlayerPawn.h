@@ -4,13 +4,72 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "Engine/EngineBaseTypes.h"
 #include "PlayerPawn.generated.h"
 
+class UInteractionFocusComponent;
+
+UENUM()
+enum class EInteractionCommandType : uint8
+{
+	Interact,
+	StopInteraction
+};
+
+/**
+* [client -> server] interaction command, sent in batches (see APlayerPawn::ServerProcessInteractionCommands).
+* Serialized as the interactive NetGUID, 1 bit command type, 8 bits wrapping sequence, 1 bit instance flag and the packed instance index
+* (only for an instance of an instanced interactive, see IInteractiveInstanced).
+* The sequence is also the prediction key of the events the command causes on server, see UInteractiveBoxComponent::bPredictInteraction.
+*/
+USTRUCT()
+struct INTERACTIONSYSTEM_API FInteractionCommand
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	FInteractionCommand();
+
+	UPROPERTY()
+	UObject* Target;
+
+	UPROPERTY()
+	EInteractionCommandType Type;
+
+	UPROPERTY()
+	uint8 Sequence;
+
+	/**
+	* instance of Target, INDEX_NONE if Target is not instanced
+	*/
+	UPROPERTY()
+	int32 Instance;
+
+	/**
+	* is this command more recent than the one with OtherSequence, wrap around included?
+	*/
+	FORCEINLINE bool IsNewerThan(uint8 OtherSequence) const { return (int8)(Sequence - OtherSequence) > 0; }
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FInteractionCommand> : public TStructOpsTypeTraitsBase2<FInteractionCommand>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
 UCLASS()
 class INTERACTIONSYSTEM_API APlayerPawn : public ACharacter
 {
 	GENERATED_BODY()
 
+	friend class UInteractionFocusComponent;
+
 public:
 	
 	APlayerPawn();
@@ -19,16 +78,24 @@ protected:
 	
 	virtual void BeginPlay() override;
 
-	UPROPERTY(EditDefaultsOnly, Category = InteractionSystem)
-	float MaxInteractionDistance;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/**
+	* Focus detection, enabled only while a local player controller possesses this pawn, see UpdateFocusEnabled
+	*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = InteractionSystem)
+	UInteractionFocusComponent* InteractionFocus;
 
 public:	
-	
-	virtual void Tick(float DeltaTime) override;
 
-	// TODO make sure to forcibly stop interaction on unpossess, so interactive component has a chance to immediately clear its reference to the current interactor
-	// not 100% sure if UnPossessed is the right place for this
-	//virtual void UnPossessed() override;
+	virtual void PossessedBy(AController* NewController) override;
+
+	/**
+	* [server] forcibly stop interaction, so the interactive component has a chance to immediately clear its reference to the current interactor
+	*/
+	virtual void UnPossessed() override;
+
+	virtual void OnRep_Controller() override;
 
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
@@ -39,28 +106,70 @@ public:
 	UFUNCTION(BlueprintCallable)
 	UObject* GetCurrentInteractive() const;
 
+	/**
+	* Get the focused instance of the current interactive if it's instanced, INDEX_NONE otherwise. Locally controlled players only, see GetCurrentInteractive.
+	*/
+	UFUNCTION(BlueprintCallable)
+	int32 GetCurrentInstance() const;
+
+	UInteractionFocusComponent* GetInteractionFocus() const { return InteractionFocus; }
+
+	/**
+	* Interact with Target, or stop interacting with it, as the Interact input does with the current interactive.
+	* On clients, the command is sent to server with the other commands of the frame (see ServerProcessInteractionCommands).
+	* Instance is the instance of an instanced Target (see IInteractiveInstanced), INDEX_NONE otherwise.
+	*/
+	void Interact(UObject* Target, int32 Instance = INDEX_NONE);
+	void StopInteraction(UObject* Target, int32 Instance = INDEX_NONE);
+
 private:
 
-	TWeakObjectPtr<UObject> CurrentInteractive;
-	
-	FTimerHandle TimerHandle_FindInteractive;
-	
-	void FindInteractive();
-	
-	void TryStopInteraction();
+	/**
+	* [server] interactive (and instance) of the last Interact that has not been stopped yet, see UnPossessed
+	*/
+	TWeakObjectPtr<UObject> ActiveInteractionTarget;
+	int32 ActiveInteractionInstance;
+
+	/**
+	* focus only for a local player controller, no focus work at all on server and for simulated proxies
+	*/
+	void UpdateFocusEnabled();
 	
 	void InteractPressed();
 	
 	void InteractReleased();
 
-	void Interact(UObject* Target);
-	void StopInteraction(UObject* Target);
+	/**
+	* [client] commands issued this frame, sent with a single RPC at the end of the frame
+	*/
+	UPROPERTY(Transient)
+	TArray<FInteractionCommand> PendingInteractionCommands;
 
-	UFUNCTION(Reliable, Server, WithValidation)
-	void ServerInteract(UObject* Target);
+	uint8 NextInteractionCommandSequence;
+
+	FDelegateHandle FlushInteractionCommandsHandle;
+
+	/**
+	* [server] last processed command, used to drop superseded or out of order commands
+	*/
+	UPROPERTY(Transient)
+	FInteractionCommand LastInteractionCommand;
+
+	bool bHasInteractionCommand;
+
+	static const int32 MaxInteractionCommandsPerBatch = 16;
+
+	/**
+	* [client] queue a command for the end of frame flush, false if it was coalesced with the pending one
+	*/
+	bool QueueInteractionCommand(UObject* Target, int32 Instance, EInteractionCommandType Type, uint8& OutSequence);
+
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void FlushInteractionCommands();
 
 	UFUNCTION(Reliable, Server, WithValidation)
-	void ServerStopInteraction(UObject* Target);
+	void ServerProcessInteractionCommands(const TArray<FInteractionCommand>& Commands);
 
 protected:
 
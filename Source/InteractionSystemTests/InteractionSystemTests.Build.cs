@@ -0,0 +1,18 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+using System.IO;
+using UnrealBuildTool;
+
+// benchmark, load test and automation tests of the interaction system, a Developer module so that it's never part of shipping (or test) builds
+public class InteractionSystemTests : ModuleRules
+{
+	public InteractionSystemTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PrivateDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InteractionSystem" });
+
+		// InteractionSystem.h (log category and stats) is at the root of the InteractionSystem module
+		PrivateIncludePaths.Add(Path.Combine(ModuleDirectory, "..", "InteractionSystem"));
+	}
+}
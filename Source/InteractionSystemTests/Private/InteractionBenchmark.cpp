@@ -0,0 +1,847 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractionBenchmark.h"
+#include "InteractionSystem.h"
+#include "InteractiveBoxComponent.h"
+#include "PlayerPawn.h"
+#include "InteractionFocusComponent.h"
+#include "InteractionSubsystem.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "CoreGlobals.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+AInteractionBenchmarkActor::AInteractionBenchmarkActor(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	InteractiveComponent = CreateDefaultSubobject<UInteractiveBoxComponent>(TEXT("InteractiveComponent"));
+	RootComponent = InteractiveComponent;
+}
+
+AInteractionBenchmarkInteractiveActor::AInteractionBenchmarkInteractiveActor(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	bUseActorImplementation = false;
+}
+
+AInteractionBenchmarkActorImplActor::AInteractionBenchmarkActorImplActor(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	bUseActorImplementation = true;
+}
+
+bool AInteractionBenchmarkInteractiveActor::CanInteract_Implementation(const UInteractiveBoxComponent* InteractiveComponent, const APawn* Interactor) const
+{
+	return true;
+}
+
+FText AInteractionBenchmarkInteractiveActor::GetMessage_Implementation(const UInteractiveBoxComponent* InteractiveComponent, const APawn* Interactor) const
+{
+	return FText::GetEmpty();
+}
+
+bool AInteractionBenchmarkInteractiveActor::IsInteractionDisabled_Implementation(const UInteractiveBoxComponent* InteractiveComponent) const
+{
+	return false;
+}
+
+bool AInteractionBenchmarkInteractiveActor::ShouldUseActorImplementation_Implementation() const
+{
+	return bUseActorImplementation;
+}
+
+#if !UE_BUILD_SHIPPING
+
+/**
+* Forwards to the actual allocator and counts allocations, while installed as GMalloc.
+* Only game thread allocations are counted, the ones of the measured operations: worker, render and audio threads keep allocating meanwhile.
+*/
+class FInteractionBenchmarkMalloc : public FMalloc
+{
+public:
+
+	FMalloc* Inner = nullptr;
+	// written by the game thread only
+	int64 NumAllocations = 0;
+
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+	{
+		if (IsInGameThread())
+		{
+			++NumAllocations;
+		}
+		return Inner->Malloc(Count, Alignment);
+	}
+
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		if (IsInGameThread())
+		{
+			++NumAllocations;
+		}
+		return Inner->Realloc(Original, Count, Alignment);
+	}
+
+	virtual void Free(void* Original) override
+	{
+		Inner->Free(Original);
+	}
+
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+	{
+		return Inner->QuantizeSize(Count, Alignment);
+	}
+
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+	{
+		return Inner->GetAllocationSize(Original, SizeOut);
+	}
+
+	virtual bool IsInternallyThreadSafe() const override
+	{
+		return Inner->IsInternallyThreadSafe();
+	}
+
+	virtual const TCHAR* GetDescriptiveName() override
+	{
+		return TEXT("InteractionBenchmarkMalloc");
+	}
+};
+
+/**
+* Spawns a grid of interactive actors and drives pawns through focus, interact and stop cycles, measuring each operation.
+* Results are logged and written as csv to Saved/Profiling/InteractionBenchmark, one row per operation.
+* The benchmark runs synchronously on the server (or standalone) world, so it can run headless, e.g.:
+* UE4Editor InteractionSystem -game -nullrhi -unattended -ExecCmds="Interaction.Benchmark Grid=32 Pawns=16 Cycles=50, Quit"
+*/
+class FInteractionBenchmark
+{
+public:
+
+	FInteractionBenchmark(UWorld* InWorld, const FString& Args)
+		: World(InWorld)
+	{
+		GridSize = 16;
+		NumPawns = 8;
+		NumCycles = 20;
+		Owner = TEXT("None");
+
+		FParse::Value(*Args, TEXT("Grid="), GridSize);
+		FParse::Value(*Args, TEXT("Pawns="), NumPawns);
+		FParse::Value(*Args, TEXT("Cycles="), NumCycles);
+		FParse::Value(*Args, TEXT("Owner="), Owner);
+
+		GridSize = FMath::Max(GridSize, 1);
+		NumPawns = FMath::Max(NumPawns, 1);
+		NumCycles = FMath::Max(NumCycles, 1);
+	}
+
+	void Run()
+	{
+		if (World == nullptr || World->GetNetMode() == NM_Client)
+		{
+			UE_LOG(LogInteraction, Warning, TEXT("Interaction.Benchmark must run on server or standalone"));
+			return;
+		}
+
+		Spawn();
+
+		for (int32 Cycle = 0; Cycle < NumCycles; ++Cycle)
+		{
+			for (int32 PawnIndex = 0; PawnIndex < Pawns.Num(); ++PawnIndex)
+			{
+				const int32 TargetIndex = (PawnIndex + Cycle * Pawns.Num()) % Targets.Num();
+				RunCycle(Pawns[PawnIndex], Targets[TargetIndex]);
+			}
+		}
+
+		for (APlayerPawn* Pawn : Pawns)
+		{
+			Pawn->GetInteractionFocus()->UpdateFocus(nullptr);
+		}
+
+		Report();
+		Cleanup();
+	}
+
+private:
+
+	enum EOperation
+	{
+		FindInteractive,
+		FocusSwitch,
+		TryInteract,
+		OnRepInteractionEvent,
+		StopInteraction,
+		NumOperations
+	};
+
+	struct FOperationStats
+	{
+		uint64 Count = 0;
+		uint64 TotalCycles = 0;
+		uint64 MinCycles = MAX_uint64;
+		uint64 MaxCycles = 0;
+		int64 NumAllocations = 0;
+	};
+
+	UWorld* World;
+
+	int32 GridSize;
+	int32 NumPawns;
+	int32 NumCycles;
+	FString Owner;
+
+	TArray<AInteractionBenchmarkActor*> Targets;
+	TArray<APlayerPawn*> Pawns;
+
+	FOperationStats Stats[NumOperations];
+
+	static FInteractionBenchmarkMalloc CountingMalloc;
+
+	static const TCHAR* GetOperationName(EOperation Operation)
+	{
+		static const TCHAR* Names[NumOperations] = { TEXT("FindInteractive"), TEXT("FocusSwitch"), TEXT("TryInteract"), TEXT("OnRep_InteractionEvent"), TEXT("StopInteraction") };
+		return Names[Operation];
+	}
+
+	static constexpr float Spacing = 64.f;
+
+	FVector GetTargetLocation(int32 Index) const
+	{
+		// vertical wall far away from level geometry
+		return FVector(0.f, (Index % GridSize) * Spacing, 100000.f + (Index / GridSize) * Spacing);
+	}
+
+	void Spawn()
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		UClass* TargetClass = AInteractionBenchmarkActor::StaticClass();
+		if (Owner == TEXT("Interactive"))
+		{
+			TargetClass = AInteractionBenchmarkInteractiveActor::StaticClass();
+		}
+		else if (Owner == TEXT("ActorImpl"))
+		{
+			TargetClass = AInteractionBenchmarkActorImplActor::StaticClass();
+		}
+
+		for (int32 Index = 0; Index < GridSize * GridSize; ++Index)
+		{
+			AInteractionBenchmarkActor* Target = World->SpawnActor<AInteractionBenchmarkActor>(TargetClass, GetTargetLocation(Index), FRotator::ZeroRotator, SpawnParams);
+			Targets.Add(Target);
+		}
+
+		for (int32 Index = 0; Index < NumPawns; ++Index)
+		{
+			APlayerPawn* Pawn = World->SpawnActor<APlayerPawn>(APlayerPawn::StaticClass(), FVector(-1000.f, Index * 100.f, 0.f), FRotator::ZeroRotator, SpawnParams);
+			Pawns.Add(Pawn);
+		}
+	}
+
+	template<typename FunctionType>
+	void Measure(EOperation Operation, FunctionType&& Function)
+	{
+		const int64 AllocationsBefore = CountingMalloc.NumAllocations;
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+
+		Function();
+
+		const uint64 Cycles = FPlatformTime::Cycles64() - StartCycles;
+		FOperationStats& OperationStats = Stats[Operation];
+		OperationStats.Count++;
+		OperationStats.TotalCycles += Cycles;
+		OperationStats.MinCycles = FMath::Min(OperationStats.MinCycles, Cycles);
+		OperationStats.MaxCycles = FMath::Max(OperationStats.MaxCycles, Cycles);
+		OperationStats.NumAllocations += CountingMalloc.NumAllocations - AllocationsBefore;
+	}
+
+	void RunCycle(APlayerPawn* Pawn, AInteractionBenchmarkActor* Target)
+	{
+		UInteractiveBoxComponent* Component = Target->InteractiveComponent;
+		const FVector ViewLocation = Target->GetActorLocation() - FVector::ForwardVector * Pawn->GetInteractionFocus()->GetMaxInteractionDistance() * 0.5f;
+
+		UObject* Interactive = nullptr;
+		int32 Instance = INDEX_NONE;
+
+		// the event a client would receive for this interaction
+		FInteractionData Event;
+		Event.Interactor = Pawn;
+		Event.bCanInteract = true;
+
+		Measure(FindInteractive, [&]() { Interactive = Pawn->GetInteractionFocus()->TraceInteractive(ViewLocation, FVector::ForwardVector, Instance); });
+		Measure(FocusSwitch, [&]() { Pawn->GetInteractionFocus()->UpdateFocus(Interactive, Instance); });
+		Measure(TryInteract, [&]() { IInteractive::Interact(Component, Pawn); });
+		Measure(OnRepInteractionEvent, [&]() { Component->OnRep_InteractionEvent(Event); });
+		Measure(StopInteraction, [&]() { IInteractive::StopInteraction(Component, Pawn); });
+	}
+
+	void Report() const
+	{
+		FString Csv = TEXT("operation,count,total_ms,avg_us,min_us,max_us,allocations,allocations_per_op,grid,pawns,owner\n");
+
+		for (int32 Operation = 0; Operation < NumOperations; ++Operation)
+		{
+			const FOperationStats& OperationStats = Stats[Operation];
+			const uint64 Count = FMath::Max<uint64>(OperationStats.Count, 1);
+			const FString Row = FString::Printf(TEXT("%s,%llu,%.4f,%.4f,%.4f,%.4f,%lld,%.3f,%d,%d,%s"),
+				GetOperationName((EOperation)Operation),
+				OperationStats.Count,
+				FPlatformTime::ToMilliseconds64(OperationStats.TotalCycles),
+				FPlatformTime::ToMilliseconds64(OperationStats.TotalCycles) * 1000.0 / Count,
+				FPlatformTime::ToMilliseconds64(OperationStats.Count ? OperationStats.MinCycles : 0) * 1000.0,
+				FPlatformTime::ToMilliseconds64(OperationStats.MaxCycles) * 1000.0,
+				OperationStats.NumAllocations,
+				(double)OperationStats.NumAllocations / Count,
+				GridSize,
+				NumPawns,
+				*Owner);
+
+			UE_LOG(LogInteraction, Display, TEXT("InteractionBenchmark,%s"), *Row);
+			Csv += Row + TEXT("\n");
+		}
+
+		const FString FileName = FPaths::ProfilingDir() / TEXT("InteractionBenchmark") / FString::Printf(TEXT("InteractionBenchmark-%s.csv"), *FDateTime::Now().ToString());
+		if (FFileHelper::SaveStringToFile(Csv, *FileName))
+		{
+			UE_LOG(LogInteraction, Display, TEXT("InteractionBenchmark results written to %s"), *FileName);
+		}
+	}
+
+	void Cleanup()
+	{
+		for (AActor* Actor : Targets)
+		{
+			Actor->Destroy();
+		}
+		for (AActor* Actor : Pawns)
+		{
+			Actor->Destroy();
+		}
+		Targets.Empty();
+		Pawns.Empty();
+	}
+
+public:
+
+	static void Execute(const TArray<FString>& Args, UWorld* World)
+	{
+		FInteractionBenchmark Benchmark(World, FString::Join(Args, TEXT(" ")));
+
+		// count allocations while the benchmark runs, the proxy is static since other threads may still be using it after it's uninstalled
+		CountingMalloc.Inner = GMalloc;
+		GMalloc = &CountingMalloc;
+
+		Benchmark.Run();
+
+		GMalloc = CountingMalloc.Inner;
+	}
+};
+
+FInteractionBenchmarkMalloc FInteractionBenchmark::CountingMalloc;
+
+static FAutoConsoleCommandWithWorldAndArgs InteractionBenchmarkCommand(
+	TEXT("Interaction.Benchmark"),
+	TEXT("Measure interaction hot paths on a grid of interactive actors. Args: Grid=<side> Pawns=<count> Cycles=<count> Owner=<None|Interactive|ActorImpl>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&FInteractionBenchmark::Execute)
+);
+
+/**
+* Load test of the server: the local player pawns of the clients walk to random interactives and interact with them, at a given rate and for a given hold time.
+* Needs the server and its clients in this process, e.g. play in editor with a dedicated server, as many players as bots and a single process:
+* bots are the clients' own APlayerPawn (see APlayerPawn::Interact), so commands go through ServerProcessInteractionCommands (serialization,
+* validation, reliable buffer) and the net driver like the ones of actual players. It can be run from any of these worlds.
+* After the warmup, bots walk around without interacting for the baseline duration, and the traffic to clients measured then (bot movement mostly)
+* is subtracted from the traffic of the measurement, so that bytes per interaction only counts what interactions cost.
+* Reports server world tick time percentiles, command batches and commands received by the server per second, and bytes sent to clients per interaction,
+* logged and written as csv to Saved/Profiling/InteractionLoadTest.
+* If the map has no interactives, a grid of replicated benchmark actors is spawned on server.
+*/
+class FInteractionLoadTest
+{
+public:
+
+	FInteractionLoadTest(const FString& Args)
+	{
+		Duration = 60.f;
+		Warmup = 2.f;
+		Baseline = 5.f;
+		InteractionRate = 0.5f;
+		HoldTime = 0.5f;
+		GridSize = 16;
+
+		FParse::Value(*Args, TEXT("Duration="), Duration);
+		FParse::Value(*Args, TEXT("Warmup="), Warmup);
+		FParse::Value(*Args, TEXT("Baseline="), Baseline);
+		FParse::Value(*Args, TEXT("Rate="), InteractionRate);
+		FParse::Value(*Args, TEXT("Hold="), HoldTime);
+		FParse::Value(*Args, TEXT("Grid="), GridSize);
+
+		Duration = FMath::Max(Duration, 1.f);
+		Warmup = FMath::Max(Warmup, 0.f);
+		Baseline = FMath::Max(Baseline, 0.f);
+		InteractionRate = FMath::Max(InteractionRate, 0.01f);
+		HoldTime = FMath::Max(HoldTime, 0.f);
+		GridSize = FMath::Max(GridSize, 1);
+
+		StartTime = 0.f;
+		bTargetsReplicated = false;
+		bMeasuringBaseline = false;
+		bMeasuring = false;
+		BaselineStartTime = 0.0;
+		BaselineStartOutBytes = 0;
+		BaselineBytesPerSecond = 0.0;
+		MeasureStartTime = 0.0;
+		StartOutBytes = 0;
+		ServerTickStartTime = 0.0;
+	}
+
+	bool Start()
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			UWorld* ContextWorld = Context.World();
+			if (ContextWorld == nullptr)
+			{
+				continue;
+			}
+			const ENetMode NetMode = ContextWorld->GetNetMode();
+			if (NetMode == NM_DedicatedServer || NetMode == NM_ListenServer)
+			{
+				World = ContextWorld;
+			}
+			else if (NetMode == NM_Client)
+			{
+				FBot& Bot = Bots.AddDefaulted_GetRef();
+				Bot.World = ContextWorld;
+			}
+		}
+
+		if (false == World.IsValid() || Bots.Num() == 0)
+		{
+			UE_LOG(LogInteraction, Warning, TEXT("Interaction.LoadTest needs the server and its clients in this process, e.g. play in editor with a dedicated server and a single process"));
+			return false;
+		}
+
+		InteractionSubsystem = UInteractionSubsystem::Get(World.Get());
+		if (false == InteractionSubsystem.IsValid())
+		{
+			UE_LOG(LogInteraction, Warning, TEXT("Interaction.LoadTest: no interaction subsystem"));
+			return false;
+		}
+
+		if (InteractionSubsystem->GetInteractives().Num() == 0)
+		{
+			SpawnTargets();
+		}
+
+		StartTime = World->GetTimeSeconds();
+		UE_LOG(LogInteraction, Display, TEXT("Interaction.LoadTest started: %d bots, %d interactives, %.1fs"), Bots.Num(), InteractionSubsystem->GetInteractives().Num(), Duration);
+		return true;
+	}
+
+	/**
+	* [server] advance the test, return false once it's over
+	*/
+	bool Tick()
+	{
+		if (false == InteractionSubsystem.IsValid())
+		{
+			return false;
+		}
+
+		const float Elapsed = World->GetTimeSeconds() - StartTime;
+		if (false == bMeasuringBaseline && false == bMeasuring && Elapsed >= Warmup)
+		{
+			// interactions of the warmup are stopped, no command is sent until the measurement
+			for (FBot& Bot : Bots)
+			{
+				StopBotInteraction(Bot);
+			}
+			bMeasuringBaseline = true;
+			BaselineStartTime = FPlatformTime::Seconds();
+			BaselineStartOutBytes = GetOutBytes();
+		}
+		if (bMeasuringBaseline && Elapsed >= Warmup + Baseline)
+		{
+			const double BaselineSeconds = FPlatformTime::Seconds() - BaselineStartTime;
+			BaselineBytesPerSecond = BaselineSeconds > 0.0 ? (GetOutBytes() - BaselineStartOutBytes) / BaselineSeconds : 0.0;
+			bMeasuringBaseline = false;
+			bMeasuring = true;
+			MeasureStartTime = FPlatformTime::Seconds();
+			StartOutBytes = GetOutBytes();
+			StartTotals = InteractionStats::GetTotals();
+			ServerTickTimes.Reset();
+		}
+
+		return Elapsed < Warmup + Baseline + Duration;
+	}
+
+	/**
+	* [client] step the bot of this world
+	*/
+	void TickBot(UWorld* BotWorld)
+	{
+		FBot* Bot = Bots.FindByPredicate([BotWorld](const FBot& Other) { return Other.World == BotWorld; });
+		if (Bot == nullptr)
+		{
+			return;
+		}
+
+		// the pawn may be respawned
+		APlayerController* Controller = BotWorld->GetFirstPlayerController();
+		APlayerPawn* Pawn = Controller ? Cast<APlayerPawn>(Controller->GetPawn()) : nullptr;
+		if (Pawn != Bot->Pawn.Get())
+		{
+			Bot->Pawn = Pawn;
+			Bot->Target = nullptr;
+			Bot->bInteracting = false;
+		}
+		if (Pawn == nullptr)
+		{
+			return;
+		}
+
+		// targets are picked among the interactives replicated to this client
+		UInteractiveBoxComponent* Target = Bot->Target.Get();
+		if (Target == nullptr)
+		{
+			const UInteractionSubsystem* ClientInteractionSubsystem = UInteractionSubsystem::Get(BotWorld);
+			const int32 NumInteractives = ClientInteractionSubsystem ? ClientInteractionSubsystem->GetInteractives().Num() : 0;
+			if (NumInteractives == 0)
+			{
+				return;
+			}
+			bTargetsReplicated = true;
+			Target = ClientInteractionSubsystem->GetInteractives()[FMath::RandHelper(NumInteractives)];
+			Bot->Target = Target;
+			Bot->bInteracting = false;
+		}
+
+		// walk up to the target, within interaction distance, with regular movement input so that movement replicates like a player's
+		const FVector ToTarget = Target->GetComponentLocation() - Pawn->GetActorLocation();
+		Controller->SetControlRotation(ToTarget.Rotation());
+		if (ToTarget.Size() > Pawn->GetInteractionFocus()->GetMaxInteractionDistance() * 0.5f)
+		{
+			Pawn->AddMovementInput(ToTarget.GetSafeNormal2D());
+			return;
+		}
+
+		const float Now = BotWorld->GetTimeSeconds();
+		if (bMeasuringBaseline || Now < Bot->NextActionTime)
+		{
+			return;
+		}
+
+		if (false == Bot->bInteracting)
+		{
+			Pawn->Interact(Target);
+			Bot->bInteracting = true;
+			Bot->NextActionTime = Now + HoldTime;
+		}
+		else
+		{
+			StopBotInteraction(*Bot);
+			Bot->Target = nullptr;
+			// rate is per bot, with some jitter so bots don't act in lockstep
+			Bot->NextActionTime = Now + FMath::FRandRange(0.5f, 1.5f) / InteractionRate;
+		}
+	}
+
+	void Finish()
+	{
+		if (World.IsValid())
+		{
+			Report();
+			Cleanup();
+		}
+		else
+		{
+			UE_LOG(LogInteraction, Warning, TEXT("Interaction.LoadTest aborted, the server world was torn down"));
+		}
+	}
+
+private:
+
+	struct FBot
+	{
+		// client world, the bot is its first local player pawn
+		TWeakObjectPtr<UWorld> World;
+		TWeakObjectPtr<APlayerPawn> Pawn;
+		TWeakObjectPtr<UInteractiveBoxComponent> Target;
+		float NextActionTime = 0.f;
+		bool bInteracting = false;
+	};
+
+	// server world, the test outlives frames so it may be torn down meanwhile
+	TWeakObjectPtr<UWorld> World;
+	TWeakObjectPtr<UInteractionSubsystem> InteractionSubsystem;
+
+	float Duration;
+	float Warmup;
+	float Baseline;
+	float InteractionRate;
+	float HoldTime;
+	int32 GridSize;
+
+	TArray<FBot> Bots;
+	TArray<TWeakObjectPtr<AActor>> SpawnedTargets;
+
+	float StartTime;
+	bool bTargetsReplicated;
+	bool bMeasuringBaseline;
+	bool bMeasuring;
+	double BaselineStartTime;
+	int64 BaselineStartOutBytes;
+	// traffic to clients while bots don't interact, see Baseline
+	double BaselineBytesPerSecond;
+	double MeasureStartTime;
+	int64 StartOutBytes;
+	InteractionStats::FTotals StartTotals;
+
+	// server world tick times of the measurement: clients tick in the same process, so the game thread frame time is not the server's
+	TArray<float> ServerTickTimes;
+	double ServerTickStartTime;
+
+	void SpawnTargets()
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParams.ObjectFlags |= RF_Transient;
+
+		static constexpr float Spacing = 400.f;
+		for (int32 Index = 0; Index < GridSize * GridSize; ++Index)
+		{
+			const FVector Location((Index % GridSize) * Spacing, (Index / GridSize) * Spacing, 100.f);
+			AInteractionBenchmarkActor* Target = World->SpawnActor<AInteractionBenchmarkActor>(AInteractionBenchmarkActor::StaticClass(), Location, FRotator::ZeroRotator, SpawnParams);
+			if (Target)
+			{
+				// replicated, so that clients have targets and measure what interactions cost
+				Target->SetReplicates(true);
+				SpawnedTargets.Add(Target);
+			}
+		}
+	}
+
+	void StopBotInteraction(FBot& Bot)
+	{
+		if (Bot.bInteracting && Bot.Pawn.IsValid() && Bot.Target.IsValid())
+		{
+			Bot.Pawn->StopInteraction(Bot.Target.Get());
+		}
+		Bot.bInteracting = false;
+	}
+
+	void OnServerTickStart()
+	{
+		ServerTickStartTime = FPlatformTime::Seconds();
+	}
+
+	/**
+	* end of the server world tick, i.e. once the next world starts ticking or the frame ends (replication included)
+	*/
+	void OnServerTickEnd()
+	{
+		if (ServerTickStartTime > 0.0)
+		{
+			if (bMeasuring)
+			{
+				ServerTickTimes.Add((FPlatformTime::Seconds() - ServerTickStartTime) * 1000.0);
+			}
+			ServerTickStartTime = 0.0;
+		}
+	}
+
+	/**
+	* total bytes sent to all clients so far
+	*/
+	int64 GetOutBytes() const
+	{
+		int64 OutBytes = 0;
+		if (const UNetDriver* NetDriver = World->GetNetDriver())
+		{
+			for (const UNetConnection* Connection : NetDriver->ClientConnections)
+			{
+				OutBytes += Connection ? Connection->OutTotalBytes : 0;
+			}
+		}
+		return OutBytes;
+	}
+
+	void Report()
+	{
+		const double MeasuredSeconds = bMeasuring ? FMath::Max(FPlatformTime::Seconds() - MeasureStartTime, 0.001) : 0.0;
+		const int32 NumConnections = World->GetNetDriver() ? World->GetNetDriver()->ClientConnections.Num() : 0;
+		const int64 OutBytes = bMeasuring ? GetOutBytes() - StartOutBytes : 0;
+		const double InteractionOutBytes = FMath::Max(OutBytes - BaselineBytesPerSecond * MeasuredSeconds, 0.0);
+
+		// received and processed by the server, whatever the clients sent
+		const InteractionStats::FTotals& Totals = InteractionStats::GetTotals();
+		const int64 NumBatches = bMeasuring ? Totals.CommandBatches - StartTotals.CommandBatches : 0;
+		const int64 NumCommands = bMeasuring ? Totals.Commands - StartTotals.Commands : 0;
+		const int64 NumInteractions = bMeasuring ? Totals.Interactions - StartTotals.Interactions : 0;
+
+		if (false == bTargetsReplicated)
+		{
+			UE_LOG(LogInteraction, Warning, TEXT("Interaction.LoadTest: no interactive was replicated to the clients, nothing was measured"));
+		}
+
+		ServerTickTimes.Sort();
+		auto Percentile = [this](float Fraction)
+		{
+			return ServerTickTimes.Num() > 0 ? ServerTickTimes[FMath::Clamp(FMath::CeilToInt(Fraction * ServerTickTimes.Num()) - 1, 0, ServerTickTimes.Num() - 1)] : 0.f;
+		};
+
+		const FString Header = TEXT("bots,interactives,seconds,frames,frame_p50_ms,frame_p90_ms,frame_p99_ms,frame_max_ms,command_batches_per_second,commands_per_second,interactions,connections,baseline_bytes_per_second,bytes_per_interaction");
+		const FString Row = FString::Printf(TEXT("%d,%d,%.2f,%d,%.3f,%.3f,%.3f,%.3f,%.2f,%.2f,%lld,%d,%.1f,%.1f"),
+			Bots.Num(),
+			InteractionSubsystem.IsValid() ? InteractionSubsystem->GetInteractives().Num() : 0,
+			MeasuredSeconds,
+			ServerTickTimes.Num(),
+			Percentile(0.5f),
+			Percentile(0.9f),
+			Percentile(0.99f),
+			ServerTickTimes.Num() > 0 ? ServerTickTimes.Last() : 0.f,
+			MeasuredSeconds > 0.0 ? NumBatches / MeasuredSeconds : 0.0,
+			MeasuredSeconds > 0.0 ? NumCommands / MeasuredSeconds : 0.0,
+			NumInteractions,
+			NumConnections,
+			BaselineBytesPerSecond,
+			// traffic to clients beyond the baseline over interactions, per client
+			NumInteractions > 0 && NumConnections > 0 ? InteractionOutBytes / NumInteractions / NumConnections : 0.0);
+
+		UE_LOG(LogInteraction, Display, TEXT("InteractionLoadTest,%s"), *Header);
+		UE_LOG(LogInteraction, Display, TEXT("InteractionLoadTest,%s"), *Row);
+
+		const FString FileName = FPaths::ProfilingDir() / TEXT("InteractionLoadTest") / FString::Printf(TEXT("InteractionLoadTest-%s.csv"), *FDateTime::Now().ToString());
+		if (FFileHelper::SaveStringToFile(Header + TEXT("\n") + Row + TEXT("\n"), *FileName))
+		{
+			UE_LOG(LogInteraction, Display, TEXT("InteractionLoadTest results written to %s"), *FileName);
+		}
+	}
+
+	void Cleanup()
+	{
+		for (FBot& Bot : Bots)
+		{
+			StopBotInteraction(Bot);
+		}
+		for (const TWeakObjectPtr<AActor>& Target : SpawnedTargets)
+		{
+			if (Target.IsValid())
+			{
+				Target->Destroy();
+			}
+		}
+		Bots.Empty();
+		SpawnedTargets.Empty();
+	}
+
+	static TUniquePtr<FInteractionLoadTest> Current;
+
+	static FDelegateHandle WorldTickStartHandle;
+	static FDelegateHandle PostActorTickHandle;
+	static FDelegateHandle EndFrameHandle;
+
+	static void OnWorldTickStart(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+	{
+		if (Current.IsValid())
+		{
+			// worlds of the process tick one after the other
+			Current->OnServerTickEnd();
+			if (InWorld == Current->World.Get())
+			{
+				Current->OnServerTickStart();
+			}
+		}
+	}
+
+	static void OnEndFrame()
+	{
+		if (Current.IsValid())
+		{
+			Current->OnServerTickEnd();
+		}
+	}
+
+	static void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+	{
+		if (false == Current.IsValid())
+		{
+			return;
+		}
+		if (false == Current->World.IsValid() || (InWorld == Current->World.Get() && false == Current->Tick()))
+		{
+			Stop();
+		}
+		else if (InWorld->GetNetMode() == NM_Client)
+		{
+			// bots act after actors ticked, before their pawn flushes its commands
+			Current->TickBot(InWorld);
+		}
+	}
+
+public:
+
+	static void Stop()
+	{
+		FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+		FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+		WorldTickStartHandle.Reset();
+		PostActorTickHandle.Reset();
+		EndFrameHandle.Reset();
+
+		if (Current.IsValid())
+		{
+			Current->Finish();
+			Current.Reset();
+		}
+	}
+
+	static void Execute(const TArray<FString>& Args, UWorld* World)
+	{
+		// a running test is stopped and reported, e.g. "Interaction.LoadTest Stop"
+		Stop();
+		if (Args.Num() > 0 && Args[0] == TEXT("Stop"))
+		{
+			return;
+		}
+
+		Current = MakeUnique<FInteractionLoadTest>(FString::Join(Args, TEXT(" ")));
+		if (Current->Start())
+		{
+			WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddStatic(&FInteractionLoadTest::OnWorldTickStart);
+			PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddStatic(&FInteractionLoadTest::OnWorldPostActorTick);
+			EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&FInteractionLoadTest::OnEndFrame);
+		}
+		else
+		{
+			Current.Reset();
+		}
+	}
+};
+
+TUniquePtr<FInteractionLoadTest> FInteractionLoadTest::Current;
+FDelegateHandle FInteractionLoadTest::WorldTickStartHandle;
+FDelegateHandle FInteractionLoadTest::PostActorTickHandle;
+FDelegateHandle FInteractionLoadTest::EndFrameHandle;
+
+static FAutoConsoleCommandWithWorldAndArgs InteractionLoadTestCommand(
+	TEXT("Interaction.LoadTest"),
+	TEXT("Server load test with the clients of this process interacting through the RPC path. Args: Duration=<s> Warmup=<s> Baseline=<s> Rate=<interactions/s per bot> Hold=<s> Grid=<side, if the map has no interactives> | Stop"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&FInteractionLoadTest::Execute)
+);
+
+#endif // !UE_BUILD_SHIPPING
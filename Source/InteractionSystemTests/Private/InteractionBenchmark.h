@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "InteractiveActor.h"
+#include "InteractionBenchmark.generated.h"
+
+class UInteractiveBoxComponent;
+class APawn;
+
+/**
+* Actor spawned by the Interaction.Benchmark command, with an interactive component and no IInteractiveActor implementation.
+*/
+UCLASS(NotBlueprintable, NotPlaceable, Transient)
+class AInteractionBenchmarkActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AInteractionBenchmarkActor(const FObjectInitializer& ObjectInitializer);
+
+	UPROPERTY(VisibleAnywhere)
+	UInteractiveBoxComponent* InteractiveComponent;
+};
+
+/**
+* Actor spawned by the Interaction.Benchmark command, with a native IInteractiveActor implementation.
+*/
+UCLASS(NotBlueprintable, NotPlaceable, Transient)
+class AInteractionBenchmarkInteractiveActor : public AInteractionBenchmarkActor, public IInteractiveActor
+{
+	GENERATED_BODY()
+
+public:
+	AInteractionBenchmarkInteractiveActor(const FObjectInitializer& ObjectInitializer);
+
+	// see IInteractiveActor::ShouldUseActorImplementation, set in the constructor since it's resolved when the component registers
+	bool bUseActorImplementation;
+
+// ~Begin IInteractiveActor Interface
+
+	virtual bool CanInteract_Implementation(const UInteractiveBoxComponent* InteractiveComponent, const APawn* Interactor) const override;
+
+	virtual FText GetMessage_Implementation(const UInteractiveBoxComponent* InteractiveComponent, const APawn* Interactor) const override;
+
+	virtual bool IsInteractionDisabled_Implementation(const UInteractiveBoxComponent* InteractiveComponent) const override;
+
+	virtual bool ShouldUseActorImplementation_Implementation() const override;
+
+// ~End IInteractiveActor Interface
+};
+
+/**
+* Actor spawned by the Interaction.Benchmark command, with a native IInteractiveActor implementation used by its interactive component.
+*/
+UCLASS(NotBlueprintable, NotPlaceable, Transient)
+class AInteractionBenchmarkActorImplActor : public AInteractionBenchmarkInteractiveActor
+{
+	GENERATED_BODY()
+
+public:
+	AInteractionBenchmarkActorImplActor(const FObjectInitializer& ObjectInitializer);
+};
@@ -0,0 +1,378 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractionTests.h"
+#include "InteractionTimerWheel.h"
+#include "InteractionSubsystem.h"
+#include "InteractiveBoxComponent.h"
+#include "PlayerPawn.h"
+#include "Engine/GameInstance.h"
+#include "GameFramework/Pawn.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+#include "UObject/UnrealType.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+bool UInteractionTestPackageMap::SerializeObject(FArchive& Ar, UClass* InClass, UObject*& Obj, FNetworkGUID* OutNetGUID)
+{
+	uint32 Index = Ar.IsSaving() && Obj ? Objects.AddUnique(Obj) + 1 : 0;
+	Ar.SerializeIntPacked(Index);
+	if (Ar.IsLoading())
+	{
+		Obj = Index > 0 && Objects.IsValidIndex(Index - 1) ? Objects[Index - 1] : nullptr;
+	}
+	return true;
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace InteractionTests
+{
+	const uint32 TestFlags = EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter;
+
+	/**
+	* write Value with its NetSerialize and read it back into OutValue, false if either failed
+	*/
+	template<typename StructType>
+	bool RoundTrip(const StructType& Value, StructType& OutValue, UPackageMap* Map, int64& OutNumBits)
+	{
+		FBitWriter Writer(0, true);
+		bool bWriteSuccess = false;
+		const_cast<StructType&>(Value).NetSerialize(Writer, Map, bWriteSuccess);
+		OutNumBits = Writer.GetNumBits();
+
+		FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+		bool bReadSuccess = false;
+		OutValue.NetSerialize(Reader, Map, bReadSuccess);
+		return bWriteSuccess && bReadSuccess && false == Reader.IsError() && Reader.AtEnd();
+	}
+
+#if ENGINE_MAJOR_VERSION > 4 || ENGINE_MINOR_VERSION >= 25
+	using FNetProperty = FProperty;
+#else
+	using FNetProperty = UProperty;
+#endif
+
+	/**
+	* bits of Value written with the generic layout of a struct without NetSerialize, the way FRepLayout serializes a fast array item:
+	* every replicated property one after the other, with its own NetSerializeItem
+	*/
+	int64 GetGenericNumBits(const UScriptStruct* Struct, const void* Value, UPackageMap* Map)
+	{
+		FBitWriter Writer(0, true);
+		for (TFieldIterator<FNetProperty> It(Struct); It; ++It)
+		{
+			if (false == It->HasAnyPropertyFlags(CPF_RepSkip))
+			{
+				for (int32 ArrayIndex = 0; ArrayIndex < It->ArrayDim; ++ArrayIndex)
+				{
+					It->NetSerializeItem(Writer, Map, const_cast<void*>(It->ContainerPtrToValuePtr<void>(Value, ArrayIndex)));
+				}
+			}
+		}
+		return Writer.GetNumBits();
+	}
+}
+
+/**
+* Timers fire on the exact tick they expire, on both sides of the level 0 (256 ticks) and level 1 (256 * 64 ticks) boundaries,
+* whatever the tick they were added on.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionTimerWheelCascadeTest, "InteractionSystem.TimerWheel.CascadeBoundaries", InteractionTests::TestFlags)
+
+bool FInteractionTimerWheelCascadeTest::RunTest(const FString& Parameters)
+{
+	const int32 Delays[] = { 1, 2, 255, 256, 257, 511, 512, 513, 16383, 16384, 16385, 16384 + 256, 2 * 16384, 2 * 16384 + 1 };
+	const int32 NumDelays = ARRAY_COUNT(Delays);
+	const int32 StartTicks[] = { 0, 1, 100, 255, 256, 16383 };
+
+	// one second ticks, so delays are tick counts
+	FInteractionTimerWheel TimerWheel(1.f);
+
+	for (const int32 StartTick : StartTicks)
+	{
+		TimerWheel.Reset(1.f);
+
+		int32 Now = 0;
+		for (; Now < StartTick; ++Now)
+		{
+			TimerWheel.Advance(1.f);
+		}
+
+		TArray<int32> FiredTicks;
+		FiredTicks.Init(INDEX_NONE, NumDelays);
+		TArray<int32> FireCounts;
+		FireCounts.Init(0, NumDelays);
+
+		for (int32 Index = 0; Index < NumDelays; ++Index)
+		{
+			TimerWheel.Add((float)Delays[Index], FSimpleDelegate::CreateLambda([&FiredTicks, &FireCounts, &Now, Index]()
+			{
+				FiredTicks[Index] = Now;
+				++FireCounts[Index];
+			}));
+		}
+
+		// removed timers never fire
+		FInteractionTimerHandle Removed = TimerWheel.Add(256.f, FSimpleDelegate::CreateLambda([this, StartTick]()
+		{
+			AddError(*FString::Printf(TEXT("removed timer fired (start tick %d)"), StartTick));
+		}));
+		TestTrue(TEXT("timer is pending"), TimerWheel.IsPending(Removed));
+		TestTrue(TEXT("timer is removed"), TimerWheel.Remove(Removed));
+		TestFalse(TEXT("removed handle is stale"), TimerWheel.IsPending(Removed));
+
+		const int32 LastTick = StartTick + Delays[NumDelays - 1];
+		while (Now < LastTick)
+		{
+			++Now;
+			TimerWheel.Advance(1.f);
+		}
+
+		for (int32 Index = 0; Index < NumDelays; ++Index)
+		{
+			TestEqual(*FString::Printf(TEXT("fire count of delay %d (start tick %d)"), Delays[Index], StartTick), FireCounts[Index], 1);
+			TestEqual(*FString::Printf(TEXT("fire tick of delay %d (start tick %d)"), Delays[Index], StartTick), FiredTicks[Index], StartTick + Delays[Index]);
+		}
+		TestEqual(TEXT("no pending timer"), TimerWheel.Num(), 0);
+	}
+
+	return true;
+}
+
+/**
+* Radius and box queries of the registry spatial hash match a brute force test of the registered bounds,
+* across cells (negative coordinates included), with entries larger than the cells, after entries moved and after entries were removed.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionRegistryQueryTest, "InteractionSystem.Registry.SpatialHashQueries", InteractionTests::TestFlags)
+
+bool FInteractionRegistryQueryTest::RunTest(const FString& Parameters)
+{
+	UGameInstance* GameInstance = NewObject<UGameInstance>(GetTransientPackage());
+	UInteractionSubsystem* Subsystem = NewObject<UInteractionSubsystem>(GameInstance);
+
+	FRandomStream Random(1234);
+	const float WorldExtent = 5000.f;
+
+	TArray<UInteractiveBoxComponent*> Registered;
+	auto SetBounds = [&Random, WorldExtent](UInteractiveBoxComponent* Component)
+	{
+		const FVector Center(Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(-500.f, 500.f));
+		Component->Bounds = FBoxSphereBounds(FBox::BuildAABB(Center, FVector(Random.FRandRange(10.f, 200.f))));
+	};
+
+	for (int32 Index = 0; Index < 500; ++Index)
+	{
+		UInteractiveBoxComponent* Component = NewObject<UInteractiveBoxComponent>(GetTransientPackage());
+		SetBounds(Component);
+		Subsystem->RegisterInteractive(Component);
+		Registered.Add(Component);
+	}
+
+	auto CheckQueries = [&](const TCHAR* Step)
+	{
+		for (int32 Query = 0; Query < 50; ++Query)
+		{
+			const FVector Center(Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(-WorldExtent, WorldExtent), 0.f);
+			const float Radius = Random.FRandRange(50.f, 2500.f);
+
+			TArray<UInteractiveBoxComponent*> InRadius;
+			Subsystem->QueryInteractivesInRadius(Center, Radius, InRadius);
+			TArray<UInteractiveBoxComponent*> InBox;
+			const FBox Box = FBox::BuildAABB(Center, FVector(Radius));
+			Subsystem->QueryInteractivesInBox(Box, InBox);
+
+			TSet<UInteractiveBoxComponent*> ExpectedInRadius;
+			TSet<UInteractiveBoxComponent*> ExpectedInBox;
+			for (UInteractiveBoxComponent* Component : Registered)
+			{
+				if (Component->Bounds.GetBox().ComputeSquaredDistanceToPoint(Center) <= FMath::Square(Radius))
+				{
+					ExpectedInRadius.Add(Component);
+				}
+				if (Component->Bounds.GetBox().Intersect(Box))
+				{
+					ExpectedInBox.Add(Component);
+				}
+			}
+
+			TestEqual(*FString::Printf(TEXT("%s: radius query count"), Step), InRadius.Num(), ExpectedInRadius.Num());
+			TestEqual(*FString::Printf(TEXT("%s: radius query without duplicates"), Step), TSet<UInteractiveBoxComponent*>(InRadius).Num(), InRadius.Num());
+			TestTrue(*FString::Printf(TEXT("%s: radius query matches"), Step), TSet<UInteractiveBoxComponent*>(InRadius).Difference(ExpectedInRadius).Num() == 0);
+
+			TestEqual(*FString::Printf(TEXT("%s: box query count"), Step), InBox.Num(), ExpectedInBox.Num());
+			TestTrue(*FString::Printf(TEXT("%s: box query matches"), Step), TSet<UInteractiveBoxComponent*>(InBox).Difference(ExpectedInBox).Num() == 0);
+		}
+	};
+
+	CheckQueries(TEXT("registered"));
+
+	// entries larger than the cells, then removed so that the next steps don't depend on them
+	TArray<UInteractiveBoxComponent*> Oversized;
+	for (int32 Index = 0; Index < 5; ++Index)
+	{
+		UInteractiveBoxComponent* Component = NewObject<UInteractiveBoxComponent>(GetTransientPackage());
+		const FVector Center(Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(-WorldExtent, WorldExtent), 0.f);
+		Component->Bounds = FBoxSphereBounds(FBox::BuildAABB(Center, FVector(Random.FRandRange(1000.f, 3000.f))));
+		Subsystem->RegisterInteractive(Component);
+		Registered.Add(Component);
+		Oversized.Add(Component);
+	}
+	CheckQueries(TEXT("oversized"));
+
+	for (UInteractiveBoxComponent* Component : Oversized)
+	{
+		Subsystem->UnregisterInteractive(Component);
+		Registered.Remove(Component);
+	}
+	CheckQueries(TEXT("oversized removed"));
+
+	// move a third of the entries, most of them to another cell
+	for (int32 Index = 0; Index < Registered.Num(); Index += 3)
+	{
+		SetBounds(Registered[Index]);
+		Subsystem->UpdateInteractive(Registered[Index]);
+	}
+	CheckQueries(TEXT("moved"));
+
+	// swap removal of entries from the middle and the end
+	for (int32 Index = Registered.Num() - 1; Index >= 0; Index -= 4)
+	{
+		Subsystem->UnregisterInteractive(Registered[Index]);
+		Registered.RemoveAt(Index);
+	}
+	TestEqual(TEXT("registered count"), Subsystem->GetInteractives().Num(), Registered.Num());
+	CheckQueries(TEXT("unregistered"));
+
+	return true;
+}
+
+/**
+* FInteractionData and FInteractionCommand read back what was written, interactor, instance and prediction bits included,
+* and the smallest event is 13 bits (interactor flag, state, sequence, prediction flag, instance flag).
+* Also measures an event against the generic struct layout of the same properties, and of the layout before the packed NetSerialize.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionNetSerializeTest, "InteractionSystem.Net.NetSerializeRoundTrip", InteractionTests::TestFlags)
+
+bool FInteractionNetSerializeTest::RunTest(const FString& Parameters)
+{
+	UInteractionTestPackageMap* Map = NewObject<UInteractionTestPackageMap>();
+	APawn* Pawn = GetMutableDefault<APawn>();
+	UObject* Target = GetMutableDefault<UInteractiveBoxComponent>();
+
+	const int32 Instances[] = { INDEX_NONE, 0, 5, 1000000, MAX_int32 };
+	const uint8 Sequences[] = { 0, 1, 255 };
+
+	enum EState { Succeeded, Denied, Stopped, HoldCompleted, NumStates };
+
+	int32 NumCases = 0;
+	for (int32 bWithInteractor = 0; bWithInteractor < 2; ++bWithInteractor)
+	{
+		for (int32 State = 0; State < NumStates; ++State)
+		{
+			for (int32 bWithPredictionKey = 0; bWithPredictionKey < 2; ++bWithPredictionKey)
+			{
+				for (const int32 Instance : Instances)
+				{
+					for (const uint8 Sequence : Sequences)
+					{
+						FInteractionData Event;
+						Event.Interactor = bWithInteractor ? Pawn : nullptr;
+						Event.bCanInteract = State == Succeeded || State == HoldCompleted;
+						Event.bStopInteraction = State == Stopped;
+						Event.bHoldCompleted = State == HoldCompleted;
+						Event.Sequence = Sequence;
+						Event.bHasPredictionKey = bWithPredictionKey;
+						Event.PredictionKey = bWithPredictionKey ? 0xA5 : 0;
+						Event.Instance = Instance;
+
+						FInteractionData Loaded;
+						// garbage to be overwritten
+						Loaded.Interactor = Pawn;
+						Loaded.Instance = 7;
+						Loaded.PredictionKey = 3;
+						int64 NumBits = 0;
+						const FString Case = FString::Printf(TEXT("event %d"), NumCases++);
+
+						TestTrue(*(Case + TEXT(" serialized")), InteractionTests::RoundTrip(Event, Loaded, Map, NumBits));
+						TestTrue(*(Case + TEXT(" interactor")), Loaded.Interactor == Event.Interactor);
+						TestTrue(*(Case + TEXT(" can interact")), Loaded.bCanInteract == Event.bCanInteract);
+						TestTrue(*(Case + TEXT(" stop")), Loaded.bStopInteraction == Event.bStopInteraction);
+						TestTrue(*(Case + TEXT(" hold completed")), Loaded.bHoldCompleted == Event.bHoldCompleted);
+						TestEqual(*(Case + TEXT(" sequence")), (int32)Loaded.Sequence, (int32)Event.Sequence);
+						TestTrue(*(Case + TEXT(" has prediction key")), Loaded.bHasPredictionKey == Event.bHasPredictionKey);
+						if (Event.bHasPredictionKey)
+						{
+							TestEqual(*(Case + TEXT(" prediction key")), (int32)Loaded.PredictionKey, (int32)Event.PredictionKey);
+						}
+						TestEqual(*(Case + TEXT(" instance")), Loaded.Instance, Event.Instance);
+
+						if (false == bWithInteractor && false == bWithPredictionKey && Instance == INDEX_NONE)
+						{
+							TestEqual(*(Case + TEXT(" bits")), (int32)NumBits, 13);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// bandwidth of a plain succeeded event, the interactor costs the same in every layout (its NetGUID, 1 byte here)
+	for (int32 bWithInteractor = 0; bWithInteractor < 2; ++bWithInteractor)
+	{
+		FInteractionData Event;
+		Event.Interactor = bWithInteractor ? Pawn : nullptr;
+		Event.bCanInteract = true;
+		Event.Sequence = 42;
+
+		FInteractionTestLegacyData LegacyEvent;
+		LegacyEvent.Interactor = Event.Interactor;
+		LegacyEvent.bCanInteract = true;
+
+		FInteractionData Loaded;
+		int64 PackedBits = 0;
+		InteractionTests::RoundTrip(Event, Loaded, Map, PackedBits);
+		const int64 GenericBits = InteractionTests::GetGenericNumBits(FInteractionData::StaticStruct(), &Event, Map);
+		const int64 LegacyBits = InteractionTests::GetGenericNumBits(FInteractionTestLegacyData::StaticStruct(), &LegacyEvent, Map);
+
+		AddInfo(FString::Printf(TEXT("event %s interactor: packed %lld bits, generic layout %lld bits, layout before NetSerialize (interactor and 2 flags only) %lld bits"),
+			bWithInteractor ? TEXT("with") : TEXT("without"), PackedBits, GenericBits, LegacyBits));
+		TestTrue(TEXT("packed event is smaller than the generic layout"), PackedBits < GenericBits);
+	}
+
+	for (int32 bWithTarget = 0; bWithTarget < 2; ++bWithTarget)
+	{
+		for (int32 bStop = 0; bStop < 2; ++bStop)
+		{
+			for (const int32 Instance : Instances)
+			{
+				for (const uint8 Sequence : Sequences)
+				{
+					FInteractionCommand Command;
+					Command.Target = bWithTarget ? Target : nullptr;
+					Command.Type = bStop ? EInteractionCommandType::StopInteraction : EInteractionCommandType::Interact;
+					Command.Sequence = Sequence;
+					Command.Instance = Instance;
+
+					FInteractionCommand Loaded;
+					Loaded.Target = Pawn;
+					Loaded.Instance = 7;
+					int64 NumBits = 0;
+					const FString Case = FString::Printf(TEXT("command %d"), NumCases++);
+
+					TestTrue(*(Case + TEXT(" serialized")), InteractionTests::RoundTrip(Command, Loaded, Map, NumBits));
+					TestTrue(*(Case + TEXT(" target")), Loaded.Target == Command.Target);
+					TestTrue(*(Case + TEXT(" type")), Loaded.Type == Command.Type);
+					TestEqual(*(Case + TEXT(" sequence")), (int32)Loaded.Sequence, (int32)Command.Sequence);
+					TestEqual(*(Case + TEXT(" instance")), Loaded.Instance, Command.Instance);
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/CoreNet.h"
+#include "InteractionTests.generated.h"
+
+class APawn;
+
+/**
+* Package map of the interaction automation tests, so that NetSerialize functions can run without a net driver.
+* Objects are written as their index in a table shared by the writer and the reader, 0 for null.
+*/
+UCLASS(Transient)
+class UInteractionTestPackageMap : public UPackageMap
+{
+	GENERATED_BODY()
+
+public:
+
+	//~ Begin UPackageMap Interface
+	virtual bool SerializeObject(FArchive& Ar, UClass* InClass, UObject*& Obj, FNetworkGUID* OutNetGUID = nullptr) override;
+	//~ End UPackageMap Interface
+
+private:
+
+	UPROPERTY()
+	TArray<UObject*> Objects;
+};
+
+/**
+* FInteractionData as it was before its NetSerialize (interactor and two flags), to measure what the generic struct layout cost.
+*/
+USTRUCT()
+struct FInteractionTestLegacyData
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	FInteractionTestLegacyData() : bCanInteract(false), bStopInteraction(false) {}
+
+	UPROPERTY()
+	TWeakObjectPtr<APawn> Interactor;
+
+	UPROPERTY()
+	uint32 bCanInteract : 1;
+
+	UPROPERTY()
+	uint32 bStopInteraction : 1;
+};